@@ -1,8 +1,10 @@
 #include "ChatBackend.h"
 #include "ConversationListModel.h"
+#include "ConversationSnapshot.h"
 #include "MessageListModel.h"
 #include "MemberListModel.h"
 #include "Identity.h"
+#include "ModuleRecords.h"
 #include "ProcessLog.h"
 
 // Generated umbrella: LogosModules (behind modules()) from
@@ -10,11 +12,18 @@
 #include "logos_sdk.h"
 
 #include <QCoreApplication>
+#include <QCryptographicHash>
 #include <QDateTime>
 #include <QDebug>
+#include <QDir>
 #include <QFileInfo>
 #include <QPointer>
+#include <QPromise>
+#include <QSettings>
+#include <QThreadPool>
 #include <QVariantMap>
+#include <algorithm>
+#include <memory>
 #include <utility>
 
 namespace {
@@ -33,13 +42,134 @@ constexpr const char* kChatLogLevel = "info";
 // long enough that a loaded box does not look like a crash.
 constexpr int kHealthIntervalMs = 10000;
 constexpr int kHealthTimeoutMs = 2000;
+// How long a read of the module's state is worth waiting for. Past it the read
+// is reported as failed and the view keeps what it had; whether the module is
+// busy or gone is the health probe's call. The read scheduler gives up at this
+// point and sends the next read; the wrapper's own timeout is set a little
+// later, so the empty answer it hands back on timing out arrives after the read
+// was given up on, and is dropped rather than taken for an empty list.
+constexpr int kReadTimeoutMs = 10000;
+constexpr int kWrapperTimeoutSlackMs = 2000;
 // Probes that must go unanswered before the module is called gone. One is a
 // hiccup; the announcement is not worth being wrong about.
 constexpr int kHealthMissesBeforeGone = 2;
 
+// How long a live message waits for others to join it before the queue goes
+// into the thread: about a frame, so a burst costs the view one relayout and
+// the replica one insert, and a lone message shows no later than it would have.
+constexpr int kLiveMessageFlushMs = 16;
+
+// How long conversation_updated events gather before the list is read again.
+// Setting up a group, or a replay after a reconnect, sends them by the dozen;
+// a quarter second folds a burst into one read and is not felt on a lone one.
+constexpr int kConversationRefreshMs = 250;
+
+// How long unread-count changes gather before they are written out. A burst of
+// messages is one write; a crash loses at most this much.
+constexpr int kUnreadSaveMs = 2000;
+
+// How long after the list gains, loses or renames a conversation it is saved
+// for the next start. Activity alone is left to the save at shutdown.
+constexpr int kSnapshotSaveMs = 5000;
+// Where the directory the last run saved its conversation list in is kept:
+// it is the module's, and known only once the module is up. One entry per
+// session directory, as every instance on the host shares the settings.
+constexpr const char* kSnapshotDirGroup = "chat_ui/snapshotDirectory/";
+
+// Memory the recently viewed threads may hold between them, by ThreadCache's
+// estimate: a few busy conversations' worth, unless the settings say otherwise
+// (in MiB; 0 turns the cache off).
+constexpr qint64 kThreadCacheBudgetBytes = 32 * 1024 * 1024;
+constexpr const char* kThreadCacheBudgetKey = "chat_ui/threadCacheBudgetMiB";
+
+// Reading ahead waits this long after the list lands or the user switches, so
+// the thread and roster just asked for go first, and stops once the cache
+// holds this much: most of it stays for threads the user has actually opened.
+// What it reads ahead is the top of the list, and anything unread below it.
+constexpr int kPrefetchIdleMs = 1000;
+constexpr qint64 kPrefetchBudgetBytes = 8 * 1024 * 1024;
+constexpr int kPrefetchTopConversations = 5;
+
 QDateTime msToDateTime(qint64 ms)
 {
-    return ms > 0 ? QDateTime::fromMSecsSinceEpoch(ms) : QDateTime::currentDateTime();
+    return QDateTime::fromMSecsSinceEpoch(ModuleRecords::msOrNow(ms));
+}
+
+// Runs `decode` on the global thread pool and hands back its result as a
+// future. Canceling the future abandons the decode: the worker sees it between
+// records, stops, and reports no result.
+template <typename T>
+QFuture<T> decodeOffThread(std::function<T(const ModuleRecords::Canceled&)> decode)
+{
+    auto promise = std::make_shared<QPromise<T>>();
+    QFuture<T> future = promise->future();
+    promise->start();
+    QThreadPool::globalInstance()->start([promise, decode = std::move(decode)] {
+        T result = decode([&promise] { return promise->isCanceled(); });
+        if (!promise->isCanceled())
+            promise->addResult(std::move(result));
+        promise->finish();
+    });
+    return future;
+}
+
+// Puts each of `live` into `thread`, oldest-first, where its timestamp places
+// it, unless the thread holds it already.
+void mergeLiveMessages(QVector<MessageItem>& thread, const QVector<MessageItem>& live)
+{
+    const auto earlier = [](const MessageItem& left, const MessageItem& right) {
+        return left.timestampMs < right.timestampMs;
+    };
+    for (const MessageItem& message : live) {
+        const auto [first, last] = std::equal_range(thread.begin(), thread.end(), message, earlier);
+        if (std::find(first, last, message) == last)
+            thread.insert(last, message);
+    }
+}
+
+// The session directory the host was started in (--user-dir, else
+// LOGOS_USER_DIR), which is what tells two instances on one host apart; empty
+// for the default one.
+QString sessionDirectory()
+{
+    const QStringList args = QCoreApplication::arguments();
+    const QString option = QStringLiteral("--user-dir");
+    for (int i = 0; i < args.size(); ++i) {
+        if (args.at(i) == option && i + 1 < args.size())
+            return args.at(i + 1);
+        if (args.at(i).startsWith(option + QLatin1Char('=')))
+            return args.at(i).mid(option.size() + 1);
+    }
+    return qEnvironmentVariable("LOGOS_USER_DIR");
+}
+
+// This instance's entry under kSnapshotDirGroup. A path is no settings key, so
+// the session directory is named by a hash of it.
+QString snapshotDirKey()
+{
+    const QString userDir = sessionDirectory();
+    const QString instance = userDir.isEmpty()
+        ? QStringLiteral("default")
+        : QString::fromLatin1(QCryptographicHash::hash(QDir(userDir).absolutePath().toUtf8(),
+                                                       QCryptographicHash::Sha1)
+                                  .toHex()
+                                  .left(16));
+    return QString::fromLatin1(kSnapshotDirGroup) + instance;
+}
+
+qint64 threadCacheBudget()
+{
+    bool ok = false;
+    const qint64 mib = QSettings().value(QString::fromLatin1(kThreadCacheBudgetKey)).toLongLong(&ok);
+    if (!ok || mib < 0)
+        return kThreadCacheBudgetBytes;
+    return mib * 1024 * 1024;
+}
+
+// Why a read given up on by the scheduler failed.
+QString noAnswerReason()
+{
+    return QStringLiteral("no answer within %1 s").arg(kReadTimeoutMs / 1000);
 }
 
 QString humanSize(qint64 bytes)
@@ -102,16 +232,67 @@ Q_COREAPP_STARTUP_FUNCTION(ensureApplicationIdentity)
 ChatBackend::ChatBackend(QObject* parent)
     : ChatBackendSimpleSource(parent)
     , m_conversationModel(new ConversationListModel(this))
-    , m_conversationProxy(new QSortFilterProxyModel(this))
+    , m_conversationSearch(new ConversationFilterModel(m_conversationModel, this))
     , m_messageModel(new MessageListModel(this))
     , m_memberModel(new MemberListModel(this))
+    , m_liveFlush(new QTimer(this))
+    , m_conversationRefresh(new QTimer(this))
+    , m_threadCache(threadCacheBudget())
+    , m_unreadSave(new QTimer(this))
+    , m_snapshotSave(new QTimer(this))
+    , m_threadDecode(new QFutureWatcher<QVector<MessageItem>>(this))
+    , m_conversationsDecode(new QFutureWatcher<QVector<ConversationItem>>(this))
+    , m_prefetch(new QTimer(this))
+    , m_prefetchDecode(new QFutureWatcher<QVector<MessageItem>>(this))
 {
-    // Present conversations newest-first without disturbing the source's
-    // insertion order; the proxy re-sorts live as last_activity changes.
-    m_conversationProxy->setSourceModel(m_conversationModel);
-    m_conversationProxy->setSortRole(ConversationListModel::LastActivityRole);
-    m_conversationProxy->setDynamicSortFilter(true);
-    m_conversationProxy->sort(0, Qt::DescendingOrder);
+    m_liveFlush->setSingleShot(true);
+    m_liveFlush->setInterval(kLiveMessageFlushMs);
+    connect(m_liveFlush, &QTimer::timeout, this, &ChatBackend::flushLiveMessages);
+    m_conversationRefresh->setSingleShot(true);
+    m_conversationRefresh->setInterval(kConversationRefreshMs);
+    connect(m_conversationRefresh, &QTimer::timeout, this, &ChatBackend::refreshUpdatedConversations);
+    m_unreadSave->setSingleShot(true);
+    m_unreadSave->setInterval(kUnreadSaveMs);
+    connect(m_unreadSave, &QTimer::timeout, this, &ChatBackend::saveUnreadCounts);
+    connect(m_conversationModel, &ConversationListModel::unreadCountChanged, this,
+            &ChatBackend::applyUnreadCount);
+    m_snapshotSave->setSingleShot(true);
+    m_snapshotSave->setInterval(kSnapshotSaveMs);
+    connect(m_snapshotSave, &QTimer::timeout, this, &ChatBackend::saveConversationSnapshot);
+    const auto snapshotChanged = [this] {
+        if (!m_snapshotSave->isActive())
+            m_snapshotSave->start();
+    };
+    connect(m_conversationModel, &QAbstractItemModel::rowsInserted, this, snapshotChanged);
+    connect(m_conversationModel, &QAbstractItemModel::rowsRemoved, this, snapshotChanged);
+    connect(m_conversationModel, &QAbstractItemModel::modelReset, this, snapshotChanged);
+    connect(m_conversationModel, &QAbstractItemModel::dataChanged, this,
+            [snapshotChanged](const QModelIndex&, const QModelIndex&, const QList<int>& roles) {
+                if (roles.isEmpty() || roles.contains(ConversationListModel::DisplayNameRole)
+                    || roles.contains(ConversationListModel::DescriptionRole))
+                    snapshotChanged();
+            });
+    connect(m_threadDecode, &QFutureWatcherBase::finished, this, &ChatBackend::landDecodedThread);
+    connect(m_conversationsDecode, &QFutureWatcherBase::finished, this,
+            &ChatBackend::landDecodedConversations);
+    m_prefetch->setSingleShot(true);
+    m_prefetch->setInterval(kPrefetchIdleMs);
+    connect(m_prefetch, &QTimer::timeout, this, &ChatBackend::prefetchNext);
+    connect(m_prefetchDecode, &QFutureWatcherBase::finished, this, &ChatBackend::landPrefetchedThread);
+    m_reads.setTimeout(kReadTimeoutMs);
+    m_reads.setFinishedHandler([](const ReadScheduler::Timing& timing) {
+        qInfo().noquote() << QStringLiteral("chat_ui: %1 read%2 (%3) waited %4 ms, %5 %6 ms")
+                                 .arg(timing.kind,
+                                      timing.key.isEmpty() ? QString()
+                                                           : QStringLiteral(" for ") + Identity::shortLabel(timing.key),
+                                      timing.priority == ReadScheduler::Priority::User ? QStringLiteral("user")
+                                                                                       : QStringLiteral("background"))
+                                 .arg(timing.waitedMs)
+                                 .arg(timing.timedOut    ? QStringLiteral("given up on after")
+                                      : timing.abandoned ? QStringLiteral("abandoned after")
+                                                         : QStringLiteral("ran"))
+                                 .arg(timing.ranMs);
+    });
 
     setChatStatus(ChatBackendSimpleSource::Stopped);
     setMyAddress(QString());
@@ -120,12 +301,18 @@ ChatBackend::ChatBackend(QObject* parent)
     setCurrentConversationId(QString());
     setLoadedConversationId(QString());
     setLogDir(QString());
+    setTotalUnread(0);
+    setConversationsStale(false);
     syncCurrentConversationMeta();
 
     // As early as this plugin can reach: the QML engine has not loaded the view
     // yet, so its warnings are caught too. The lines are held in memory until
     // openRunLogs finds somewhere to put them.
     ProcessLog::install();
+
+    // Before the view's first paint, which then lists the conversations the
+    // module will take seconds to.
+    restoreConversationSnapshot();
 }
 
 void ChatBackend::onContextReady()
@@ -138,13 +325,20 @@ void ChatBackend::onContextReady()
 
 ChatBackend::~ChatBackend()
 {
+    saveUnreadCounts();
+    saveConversationSnapshot();
     if (isContextReady())
         modules().chat_module.shutdown();
 }
 
 QAbstractItemModel* ChatBackend::conversationModel() const
 {
-    return m_conversationProxy;
+    return m_conversationModel;
+}
+
+QAbstractItemModel* ChatBackend::conversationSearchModel() const
+{
+    return m_conversationSearch;
 }
 
 MessageListModel* ChatBackend::messageModel() const
@@ -193,7 +387,7 @@ void ChatBackend::initialiseModule()
     // recovery refetch through applyDeliveryState instead of being dropped by
     // the m_initialSnapshotDone gate — which previously left history missing
     // until a reconnect that never came.
-    rehydrateConversations();
+    rehydrateConversations(ReadScheduler::Priority::User);
     m_initialSnapshotDone = true;
 
     // Seed delivery state from the snapshot in case delivery_state_changed
@@ -254,6 +448,29 @@ void ChatBackend::openRunLogs()
     // LogosUiPluginContext hands one over.
     const QString directory = QFileInfo(m_moduleLogPath).absolutePath();
     setLogDir(directory);
+    // So the next start can list the conversations before it gets this far.
+    m_snapshotPath = QDir(directory).filePath(QString::fromLatin1(ConversationSnapshot::kFileName));
+    QSettings().setValue(snapshotDirKey(), directory);
+
+    // Before the first read of the list, which takes each conversation's count
+    // from here. An unreadable file costs the badges, not the run. Opened
+    // already when the snapshot was restored from this directory, and kept:
+    // opening again would drop what changed since.
+    const QString unreadPath = QDir(directory).filePath(QString::fromLatin1(UnreadStore::kFileName));
+    if (m_unread.path() != unreadPath) {
+        // Restored from another directory, the list and counts at hand are
+        // not this instance's. They go, unsaved: the store is let go first, so
+        // the rows leaving do not zero its counts.
+        if (conversationsStale()) {
+            m_unread = UnreadStore();
+            m_conversationModel->clear();
+            m_snapshotSave->stop();
+            m_unreadSave->stop();
+            setConversationsStale(false);
+        }
+        if (!m_unread.open(directory))
+            qWarning().noquote() << "chat_ui: unread counts not restored from" << m_unread.path();
+    }
 
     if (ProcessLog::openIn(directory))
         m_viewLogPath = ProcessLog::path();
@@ -299,34 +516,131 @@ void ChatBackend::subscribeToEvents()
     });
 }
 
-void ChatBackend::rehydrateConversations()
+void ChatBackend::rehydrateConversations(ReadScheduler::Priority priority)
 {
     if (!m_moduleInitialised) return;
 
-    const QVariantList convos = modules().chat_module.list_conversations();
-    // Unread counts live only here, so carry them across the rebuild.
-    const QHash<QString, int> unread = m_conversationModel->unreadCounts();
-    m_conversationModel->clear();
-    for (const QVariant& v : convos) {
-        const QVariantMap obj = v.toMap();
-        const QString convoId = obj.value(QStringLiteral("convo_id")).toString();
-        if (convoId.isEmpty()) continue;
-        const QString nickname = obj.value(QStringLiteral("nickname")).toString();
-        const QString name = obj.value(QStringLiteral("name")).toString();
-        const QString description = obj.value(QStringLiteral("description")).toString();
-        const QString preview = obj.value(QStringLiteral("preview")).toString();
-        const qint64 lastActivity = obj.value(QStringLiteral("last_activity_ms")).toLongLong();
-        const bool isGroup = obj.value(QStringLiteral("kind")).toString() == QStringLiteral("group");
-        // Local nickname wins, then the group's shared name, else a generated label.
-        const QString displayName = !nickname.isEmpty() ? nickname
-            : !name.isEmpty()                           ? name
-                                                        : fallbackDisplayName(convoId, QString(), isGroup);
-        m_conversationModel->addConversation(convoId, displayName, description,
-                                             msToDateTime(lastActivity), isGroup, preview);
-    }
-    m_conversationModel->restoreUnreadCounts(unread);
+    const auto start = [this](quint64 ticket) {
+        // Only the latest read lands: one asked for since supersedes this one.
+        const quint64 read = ++m_conversationReads;
+        QPointer<ChatBackend> self(this);
+        modules().chat_module.list_conversationsAsync(
+            [self, read, ticket](const QVariantList& records) {
+                if (!self || !self->m_reads.finish(ticket) || read != self->m_conversationReads)
+                    return;
+                // Events and replies reach this thread in order, so the edits
+                // made so far are in the answer; only those made during the
+                // decode are not.
+                self->m_conversationsDecode->cancel();
+                self->m_editedSinceRead.clear();
+                self->m_deletedSinceRead.clear();
+                self->m_conversationsDecode->setFuture(decodeOffThread<QVector<ConversationItem>>(
+                    [records](const ModuleRecords::Canceled& canceled) {
+                        return ModuleRecords::decodeConversations(records, canceled);
+                    }));
+            },
+            Timeout(kReadTimeoutMs + kWrapperTimeoutSlackMs));
+    };
+    m_reads.request(QStringLiteral("list_conversations"), QString(), priority, start, [this] {
+        reportFailure(QStringLiteral("Could not load conversations"), noAnswerReason());
+    });
+}
+
+void ChatBackend::landDecodedConversations()
+{
+    QFuture<QVector<ConversationItem>> future = m_conversationsDecode->future();
+    if (!future.isFinished() || future.isCanceled() || future.resultCount() == 0)
+        return;
+
+    // Events since the read are newer than it, and under steady traffic there
+    // is always one, so the read is merged with them rather than asked for
+    // again. A conversation deleted since stays gone; one a message or its
+    // creation touched keeps the activity and preview it has now, and stays
+    // listed if the read predates it. The module keeps no unread counts, so
+    // one new to the list starts at the count saved for it; rows already
+    // listed keep their own.
+    QVector<ConversationItem> conversations;
+    QSet<QString> listed;
+    const QVector<ConversationItem>& rows = m_conversationModel->conversations();
+    for (ConversationItem& item : future.takeResult()) {
+        const QString& id = item.conversationId;
+        if (m_deletedSinceRead.contains(id))
+            continue;
+        const int row = m_conversationModel->indexOf(id);
+        if (row >= 0 && m_editedSinceRead.contains(id)) {
+            item.lastActivity = rows.at(row).lastActivity;
+            item.preview = rows.at(row).preview;
+        }
+        item.unreadCount = m_unread.count(id);
+        listed.insert(id);
+        conversations.append(std::move(item));
+    }
+    for (const QString& id : std::as_const(m_editedSinceRead)) {
+        const int row = m_conversationModel->indexOf(id);
+        if (row >= 0 && !listed.contains(id))
+            conversations.append(rows.at(row));
+    }
+    m_editedSinceRead.clear();
+    m_deletedSinceRead.clear();
+    m_conversationModel->reconcile(std::move(conversations));
+    // Saved counts for conversations the module no longer has.
+    const QStringList saved = m_unread.conversations();
+    for (const QString& convoId : saved) {
+        if (!m_conversationModel->contains(convoId))
+            applyUnreadCount(convoId, 0);
+    }
+    setConversationsStale(false);
     // The rebuilt list may now know the current conversation's kind/name.
     syncCurrentConversationMeta();
+    m_prefetch->start();
+}
+
+void ChatBackend::applyUnreadCount(const QString& convoId, int count)
+{
+    m_unread.set(convoId, count);
+    setTotalUnread(m_conversationModel->totalUnread());
+    if (m_unread.isDirty() && !m_unreadSave->isActive())
+        m_unreadSave->start();
+}
+
+void ChatBackend::saveUnreadCounts()
+{
+    m_unreadSave->stop();
+    if (!m_unread.save())
+        qWarning().noquote() << "chat_ui: unread counts not saved to" << m_unread.path();
+}
+
+void ChatBackend::restoreConversationSnapshot()
+{
+    const QString directory = QSettings().value(snapshotDirKey()).toString();
+    if (directory.isEmpty())
+        return;
+    m_snapshotPath = QDir(directory).filePath(QString::fromLatin1(ConversationSnapshot::kFileName));
+    QVector<ConversationItem> conversations;
+    if (!ConversationSnapshot::load(m_snapshotPath, &conversations))
+        return;
+
+    // The badges come back with the rows, from the counts saved beside them.
+    // openRunLogs keeps the store open if the module names the same
+    // directory.
+    if (!m_unread.open(directory))
+        qWarning().noquote() << "chat_ui: unread counts not restored from" << m_unread.path();
+    for (ConversationItem& item : conversations)
+        item.unreadCount = m_unread.count(item.conversationId);
+    setConversationsStale(true);
+    m_conversationModel->reconcile(std::move(conversations));
+    qInfo().noquote() << QStringLiteral("chat_ui: listed %1 conversations from the last run's snapshot")
+                             .arg(m_conversationModel->rowCount());
+}
+
+void ChatBackend::saveConversationSnapshot()
+{
+    m_snapshotSave->stop();
+    // A list not yet read from the module is the snapshot already.
+    if (m_snapshotPath.isEmpty() || conversationsStale())
+        return;
+    if (!ConversationSnapshot::save(m_snapshotPath, m_conversationModel->conversations()))
+        qWarning().noquote() << "chat_ui: conversation list not saved to" << m_snapshotPath;
 }
 
 void ChatBackend::refreshMyAddress()
@@ -334,14 +648,32 @@ void ChatBackend::refreshMyAddress()
     if (chatStatus() != ChatBackendSimpleSource::Online || !isContextReady())
         return;
 
-    const QString address = modules().chat_module.get_address();
-    if (address.isEmpty()) {
-        report(QStringLiteral("Failed to get your address"));
-        return;
-    }
-    setMyAddress(address);
-    setMyLabel(Identity::shortLabel(address));
-    setMyInitials(Identity::initials(address));
+    // Nothing on screen waits on it but the roster, which is read again when
+    // it lands.
+    const auto start = [this](quint64 ticket) {
+        QPointer<ChatBackend> self(this);
+        modules().chat_module.get_addressAsync(
+            [self, ticket](const QString& address) {
+                if (!self || !self->m_reads.finish(ticket))
+                    return;
+                if (address.isEmpty()) {
+                    self->reportFailure(QStringLiteral("Failed to get your address"), QString());
+                    return;
+                }
+                const bool wasUnknown = self->myAddress().isEmpty();
+                self->setMyAddress(address);
+                self->setMyLabel(Identity::shortLabel(address));
+                self->setMyInitials(Identity::initials(address));
+                // A roster read without it could not tell our own entry from
+                // the others.
+                if (wasUnknown && !self->currentConversationId().isEmpty())
+                    self->requestMembers(ReadScheduler::Priority::Background);
+            },
+            Timeout(kReadTimeoutMs + kWrapperTimeoutSlackMs));
+    };
+    m_reads.request(QStringLiteral("get_address"), QString(), ReadScheduler::Priority::Background, start, [this] {
+        reportFailure(QStringLiteral("Failed to get your address"), noAnswerReason());
+    });
 }
 
 // Push the current conversation's derived view state (group flag, display name)
@@ -358,45 +690,237 @@ void ChatBackend::syncCurrentConversationMeta()
     setCurrentAvatarRamp(Identity::avatarRamp(Identity::shortLabel(id)));
 }
 
-bool ChatBackend::showConversationMessages(const QString& convoId)
+void ChatBackend::showConversationMessages(const QString& convoId, ReadScheduler::Priority priority)
 {
-    if (convoId.isEmpty()) {
+    if (convoId.isEmpty() || !m_moduleInitialised) {
         m_messageModel->clear();
-        return true;
+        return;
     }
-    if (!m_moduleInitialised) {
-        m_messageModel->clear();
-        return false;
+    loadThread(convoId, false, priority);
+}
+
+void ChatBackend::revalidateThread(const QString& convoId, ReadScheduler::Priority priority)
+{
+    if (convoId != currentConversationId())
+        return;
+    loadThread(convoId, true, priority);
+}
+
+void ChatBackend::loadThread(const QString& convoId, bool reconcile, ReadScheduler::Priority priority)
+{
+    // From the ask, not the answer: live messages wait in the queue from now
+    // until the thread has landed, and a read or decode already under way is
+    // for a thread no longer wanted.
+    cancelThreadDecode();
+    m_decodingConversationId = convoId;
+    m_decodeReconciles = reconcile;
+    const quint64 read = m_threadReads;
+
+    const auto start = [this, read, convoId](quint64 ticket) {
+        QPointer<ChatBackend> self(this);
+        modules().chat_module.get_messagesAsync(
+            convoId,
+            [self, read, ticket, convoId](QVariantList records) {
+                if (!self || !self->m_reads.finish(ticket))
+                    return;
+                if (read != self->m_threadReads || convoId != self->m_decodingConversationId)
+                    return;
+                // The async form carries no error, and a failed read comes back
+                // as an empty list: an empty thread and an unreachable module
+                // must not look alike. A thread on screen does not empty
+                // itself, so an empty answer to its revalidation is taken for a
+                // failure: the model keeps what it had, and the held messages
+                // join it.
+                if (records.isEmpty() && self->m_decodeReconciles && self->m_messageModel->rowCount() > 0) {
+                    self->failThreadRead(QStringLiteral("the chat module returned no messages"));
+                    return;
+                }
+                // Any other empty answer is asked again the way that reports
+                // the error. Only a thread that really is empty, or a module
+                // gone, pays for the blocking call.
+                if (records.isEmpty()) {
+                    logos::CallError err;
+                    records = self->modules().chat_module.get_messages(convoId, &err);
+                    if (!self || read != self->m_threadReads || convoId != self->m_decodingConversationId)
+                        return;
+                    if (!err.ok()) {
+                        self->failThreadRead(QString::fromStdString(err.message));
+                        return;
+                    }
+                }
+                // Events and replies reach this thread in order, so any message
+                // queued before this reply was pushed before the module
+                // answered, and the thread it returns already holds it.
+                self->m_pendingLiveMessages.clear();
+                self->m_flushedSinceRead.clear();
+                // Turning the records into rows is most of the time a switch
+                // takes for a long thread, so it is done off the GUI thread.
+                self->m_threadDecode->setFuture(decodeOffThread<QVector<MessageItem>>(
+                    [records](const ModuleRecords::Canceled& canceled) {
+                        return ModuleRecords::decodeMessages(records, canceled);
+                    }));
+            },
+            Timeout(kReadTimeoutMs + kWrapperTimeoutSlackMs));
+    };
+    m_reads.request(QStringLiteral("get_messages"), convoId, priority, start, [this, read, convoId] {
+        if (read == m_threadReads && convoId == m_decodingConversationId)
+            failThreadRead(noAnswerReason());
+    });
+}
+
+void ChatBackend::failThreadRead(const QString& reason)
+{
+    m_decodingConversationId.clear();
+    m_flushedSinceRead.clear();
+    reportFailure(QStringLiteral("Could not load messages"), reason);
+    flushLiveMessages();
+}
+
+void ChatBackend::landDecodedThread()
+{
+    QFuture<QVector<MessageItem>> future = m_threadDecode->future();
+    const QString convoId = m_decodingConversationId;
+    if (convoId.isEmpty() || !future.isFinished() || future.isCanceled() || future.resultCount() == 0)
+        return;
+    m_decodingConversationId.clear();
+    if (convoId != currentConversationId())
+        return;
+
+    // Pushed since the module answered: newer than the read, so they join what
+    // it returned, for the cache entry it replaces and for the rows.
+    QVector<MessageItem> rows = future.takeResult();
+    mergeLiveMessages(rows, std::exchange(m_flushedSinceRead, {}));
+    mergeLiveMessages(rows, std::exchange(m_pendingLiveMessages, {}));
+    m_threadCache.store(convoId, rows);
+    if (m_decodeReconciles)
+        m_messageModel->reconcile(std::move(rows));
+    else
+        m_messageModel->setMessages(std::move(rows));
+    setLoadedConversationId(convoId);
+}
+
+void ChatBackend::cancelThreadDecode()
+{
+    ++m_threadReads;
+    m_reads.cancel(QStringLiteral("get_messages"));
+    m_threadDecode->cancel();
+    m_decodingConversationId.clear();
+    m_flushedSinceRead.clear();
+}
+
+void ChatBackend::prefetchNext()
+{
+    if (!m_moduleInitialised || !m_prefetchingConversationId.isEmpty())
+        return;
+    if (chatStatus() != ChatBackendSimpleSource::Online || !isContextReady())
+        return;
+    // Only into a quiet module: one read at a time goes out, and a switch
+    // abandons this one, so a read the user asks for meanwhile does not wait
+    // behind it.
+    if (m_reads.isRunning() || m_reads.waiting() > 0) {
+        m_prefetch->start();
+        return;
     }
+    if (m_threadCache.bytes() >= kPrefetchBudgetBytes)
+        return;
 
-    // A failed read comes back as an empty list, so ask for the error too: an
-    // empty thread and an unreachable module must not look alike.
-    logos::CallError err;
-    const QVariantList msgs = modules().chat_module.get_messages(convoId, &err);
-    if (!err.ok()) {
-        const QString reason = QString::fromStdString(err.message);
-        reportFailure(QStringLiteral("Could not load messages"), reason);
-        return false;
+    QString next;
+    const QStringList likely = m_conversationModel->likelyNext(kPrefetchTopConversations);
+    for (const QString& convoId : likely) {
+        if (convoId != currentConversationId() && !m_threadCache.contains(convoId)) {
+            next = convoId;
+            break;
+        }
     }
+    if (next.isEmpty())
+        return;
+
+    m_prefetchingConversationId = next;
+    const auto start = [this, next](quint64 ticket) {
+        QPointer<ChatBackend> self(this);
+        modules().chat_module.get_messagesAsync(
+            next,
+            [self, ticket, next](const QVariantList& records) {
+                if (!self || !self->m_reads.finish(ticket) || next != self->m_prefetchingConversationId)
+                    return;
+                // An empty answer may be a failed read; not worth caching
+                // either way.
+                if (records.isEmpty()) {
+                    self->m_prefetchingConversationId.clear();
+                    return;
+                }
+                self->m_prefetchDecode->setFuture(decodeOffThread<QVector<MessageItem>>(
+                    [records](const ModuleRecords::Canceled& canceled) {
+                        return ModuleRecords::decodeMessages(records, canceled);
+                    }));
+            },
+            Timeout(kReadTimeoutMs + kWrapperTimeoutSlackMs));
+    };
+    // Nobody is waiting on it, so a failure is only logged, and reading ahead
+    // stops until the next switch.
+    m_reads.request(QStringLiteral("prefetch_messages"), next, ReadScheduler::Priority::Background, start,
+                    [this, next] {
+        if (next != m_prefetchingConversationId)
+            return;
+        m_prefetchingConversationId.clear();
+        qWarning().noquote() << "chat_ui: read-ahead of" << Identity::shortLabel(next) << "failed:"
+                             << noAnswerReason();
+    });
+}
 
-    QVector<MessageItem> rows;
-    rows.reserve(msgs.size());
-    for (const QVariant& v : msgs) {
-        const QVariantMap obj = v.toMap();
-        const bool fromSelf = obj.value(QStringLiteral("from_self")).toBool();
-        const QString content = obj.value(QStringLiteral("content")).toString();
-        const qint64 ts = obj.value(QStringLiteral("timestamp_ms")).toLongLong();
-        const QString sender = obj.value(QStringLiteral("sender")).toString();
-        rows.append({ fromSelf ? QStringLiteral("Me") : shortSenderLabel(sender),
-                      content, msToDateTime(ts), fromSelf });
+void ChatBackend::landPrefetchedThread()
+{
+    QFuture<QVector<MessageItem>> future = m_prefetchDecode->future();
+    const QString convoId = m_prefetchingConversationId;
+    if (convoId.isEmpty() || !future.isFinished() || future.isCanceled() || future.resultCount() == 0)
+        return;
+    m_prefetchingConversationId.clear();
+
+    // Opened meanwhile, it is being read for the screen already. Otherwise it
+    // is cached only into the room reading ahead may use, checked here too: a
+    // thread can land well over what the check before the read left spare.
+    // Live messages that arrived during the decode are missing from it until
+    // the revalidation that opening it runs.
+    if (convoId != currentConversationId()) {
+        if (!m_threadCache.warm(convoId, future.takeResult(), kPrefetchBudgetBytes))
+            return;
+        qInfo().noquote() << QStringLiteral("chat_ui: read ahead %1, %2 threads in %3 of %4")
+                                 .arg(Identity::shortLabel(convoId))
+                                 .arg(m_threadCache.size())
+                                 .arg(humanSize(m_threadCache.bytes()), humanSize(m_threadCache.budget()));
     }
-    m_messageModel->setMessages(std::move(rows));
-    return true;
+    m_prefetch->start();
 }
 
-void ChatBackend::deferToEventLoop(std::function<void()> work)
+void ChatBackend::cancelPrefetch()
 {
-    QMetaObject::invokeMethod(this, std::move(work), Qt::QueuedConnection);
+    m_prefetch->stop();
+    m_reads.cancel(QStringLiteral("prefetch_messages"));
+    m_reads.abandon(QStringLiteral("prefetch_messages"));
+    m_prefetchDecode->cancel();
+    m_prefetchingConversationId.clear();
+}
+
+void ChatBackend::queueLiveMessage(MessageItem message)
+{
+    m_pendingLiveMessages.append(std::move(message));
+    if (!m_liveFlush->isActive())
+        m_liveFlush->start();
+}
+
+void ChatBackend::flushLiveMessages()
+{
+    m_liveFlush->stop();
+    // Held while a thread is being loaded fresh: the rows on screen are about
+    // to be replaced, and landDecodedThread adds them to what replaces them.
+    // A revalidation keeps the rows, so they go straight in; the dedupe and
+    // the reconcile absorb any overlap with its read.
+    const bool reading = !m_decodingConversationId.isEmpty();
+    if (m_pendingLiveMessages.isEmpty() || (reading && !m_decodeReconciles))
+        return;
+    if (reading)
+        m_flushedSinceRead.append(m_pendingLiveMessages);
+    m_messageModel->addNewMessages(std::exchange(m_pendingLiveMessages, {}));
 }
 
 // ── .rep slot implementations ───────────────────────────────────────────────
@@ -461,7 +985,7 @@ void ChatBackend::addGroupMember(QString conversationId, QString peerAddress)
     // The commit is async, so the peer joins the roster as a pending busy row;
     // the members_changed event reconciles it once committed.
     if (conversationId == currentConversationId())
-        refreshMembers();
+        requestMembers(ReadScheduler::Priority::User);
 }
 
 void ChatBackend::sendMessage(QString conversationId, QString content)
@@ -491,24 +1015,60 @@ void ChatBackend::selectConversation(QString conversationId)
 
     setLoadedConversationId(QString());
     setCurrentConversationId(conversationId);
+    // Queued live messages, and a thread still being decoded, belong to the
+    // conversation being left.
+    m_pendingLiveMessages.clear();
+    cancelThreadDecode();
     syncCurrentConversationMeta();
     m_conversationModel->clearUnread(conversationId);
-    const bool loaded = showConversationMessages(conversationId);
+    // A thread seen recently goes on screen from the cache, and the module is
+    // asked for it meanwhile, to reconcile the rows with when it answers.
+    QVector<MessageItem> cached;
+    bool loaded = false;
+    if (m_moduleInitialised && !conversationId.isEmpty()) {
+        const bool hit = m_threadCache.lookup(conversationId, &cached);
+        qInfo().noquote() << QStringLiteral("chat_ui: thread cache %1 for %2: %3 hits, %4 misses, "
+                                            "%5 threads in %6 of %7")
+                                 .arg(hit ? QStringLiteral("hit") : QStringLiteral("miss"),
+                                      Identity::shortLabel(conversationId))
+                                 .arg(m_threadCache.hits())
+                                 .arg(m_threadCache.misses())
+                                 .arg(m_threadCache.size())
+                                 .arg(humanSize(m_threadCache.bytes()),
+                                      humanSize(m_threadCache.budget()));
+        setThreadCacheHits(m_threadCache.hits());
+        setThreadCacheMisses(m_threadCache.misses());
+        if (hit) {
+            m_messageModel->setMessages(std::move(cached));
+            loaded = true;
+            revalidateThread(conversationId, ReadScheduler::Priority::User);
+        }
+    }
+    if (!loaded)
+        showConversationMessages(conversationId, ReadScheduler::Priority::User);
     // Reset the roster on every switch: a conversation whose roster we can't
     // fetch right now (offline) must show empty, not the previous conversation's
     // members. refreshMembers then loads the new roster when it can, and keeps
     // the last-known one across a transient offline of the same conversation.
-    // User-driven, so its synchronous read is safe here (not in an event callback).
     m_memberModel->clear();
     setMemberCount(0);
     setPendingMemberCount(0);
     setCurrentPeerAddress(QString());
-    refreshMembers();
+    requestMembers(ReadScheduler::Priority::User);
+    // A read-ahead out holds the one slot the user's reads just queued for.
+    // Given up on after they are queued, so they are what goes out next.
+    cancelPrefetch();
     if (loaded)
         setLoadedConversationId(conversationId);
+    m_prefetch->start();
 }
 
 void ChatBackend::refreshMembers()
+{
+    requestMembers(ReadScheduler::Priority::User);
+}
+
+void ChatBackend::requestMembers(ReadScheduler::Priority priority)
 {
     const QString convoId = currentConversationId();
     if (convoId.isEmpty()) {
@@ -522,16 +1082,38 @@ void ChatBackend::refreshMembers()
         return; // can't fetch now; keep the last-known roster
 
     // Telling our own entry from the others needs our address; recover it here
-    // if the online transition could not.
+    // if the online transition could not. The roster is read again when it
+    // lands.
     if (myAddress().isEmpty())
         refreshMyAddress();
 
+    // Only the latest read lands, and only while its conversation is on screen.
+    const quint64 read = ++m_memberReads;
+    const auto start = [this, read, convoId](quint64 ticket) {
+        QPointer<ChatBackend> self(this);
+        modules().chat_module.list_group_membersAsync(
+            convoId,
+            [self, read, ticket, convoId](const QVariantList& members) {
+                if (!self || !self->m_reads.finish(ticket))
+                    return;
+                if (read != self->m_memberReads || convoId != self->currentConversationId())
+                    return;
+                self->applyMembers(convoId, members);
+            },
+            Timeout(kReadTimeoutMs + kWrapperTimeoutSlackMs));
+    };
+    m_reads.request(QStringLiteral("list_group_members"), convoId, priority, start, [this, read, convoId] {
+        if (read == m_memberReads && convoId == currentConversationId())
+            reportFailure(QStringLiteral("Could not load members"), noAnswerReason());
+    });
+}
+
+void ChatBackend::applyMembers(const QString& convoId, const QVariantList& members)
+{
     // list_group_members returns [GroupMember], so the typed wrapper is a
     // QVariantList (each element a QVariantMap), like the other record lists.
-    const QVariantList members = modules().chat_module.list_group_members(convoId);
     QVector<MemberItem> rows;
     rows.reserve(members.size());
-    int committed = 0;
     for (const QVariant& v : members) {
         const QVariantMap record = v.toMap();
         const QString address = record.value(QStringLiteral("address")).toString();
@@ -540,15 +1122,13 @@ void ChatBackend::refreshMembers()
         // it — the model renders it as "unknown_account". Only a real account
         // address can be self.
         rows.append({ address, !address.isEmpty() && address == myAddress(), pending });
-        if (!pending)
-            ++committed;
     }
 
     m_memberModel->setMembers(rows);
     // Committed roster size only; pending invites appear in the list and are
     // counted separately.
-    setMemberCount(committed);
-    setPendingMemberCount(static_cast<int>(members.size()) - committed);
+    setMemberCount(m_memberModel->committedCount());
+    setPendingMemberCount(m_memberModel->pendingCount());
     // With our own address unknown every entry looks like the peer, so leave it
     // unset rather than guess.
     setCurrentPeerAddress(myAddress().isEmpty()
@@ -556,6 +1136,12 @@ void ChatBackend::refreshMembers()
                               : peerAddressOf(rows, m_conversationModel->isGroupFor(convoId)));
 }
 
+void ChatBackend::fetchOlderMessages()
+{
+    if (m_messageModel->canFetchMore(QModelIndex()))
+        m_messageModel->fetchMore(QModelIndex());
+}
+
 void ChatBackend::refreshSessionLogs()
 {
     QVariantList published;
@@ -564,6 +1150,11 @@ void ChatBackend::refreshSessionLogs()
     setLogRuns(published);
 }
 
+void ChatBackend::setConversationFilter(QString query)
+{
+    m_conversationSearch->setQuery(query);
+}
+
 // ── event handlers ────────────────────────────────────────────────────────────
 
 void ChatBackend::applyDeliveryState(const QString& state, const QString& detail)
@@ -596,24 +1187,33 @@ void ChatBackend::applyDeliveryState(const QString& state, const QString& detail
 
     // Events are push-only, so a fresh online transition (reconnect) is our
     // cue to refetch the lists and recover anything missed while offline.
-    // Deferred: this runs inside a module event callback and the refetch makes
-    // synchronous module reads (see deferToEventLoop).
-    if (becameOnline && m_initialSnapshotDone) {
-        deferToEventLoop([this] {
-            refreshMyAddress();
-            rehydrateConversations();
-            const QString convoId = currentConversationId();
-            if (convoId.isEmpty())
-                return;
-            // The refetch replaces the thread, so the models stop holding it
-            // until the reload lands.
-            setLoadedConversationId(QString());
-            const bool loaded = showConversationMessages(convoId);
-            refreshMembers();
-            if (loaded)
-                setLoadedConversationId(convoId);
-        });
+    if (becameOnline && m_initialSnapshotDone)
+        resyncAfterReconnect();
+}
+
+void ChatBackend::resyncAfterReconnect()
+{
+    // Threads off screen may have missed messages while offline, and so may
+    // one being read ahead. The list landing starts reading ahead again.
+    cancelPrefetch();
+    m_threadCache.clear();
+    refreshMyAddress();
+    rehydrateConversations(ReadScheduler::Priority::Background);
+    const QString convoId = currentConversationId();
+    if (convoId.isEmpty())
+        return;
+    // A thread already on screen is brought up to date in place, so the rows,
+    // and where the user had scrolled to, survive the reconnect.
+    if (convoId == loadedConversationId()) {
+        revalidateThread(convoId, ReadScheduler::Priority::Background);
+        requestMembers(ReadScheduler::Priority::Background);
+        return;
     }
+    // Otherwise the refetch replaces the thread, so the models stop holding it
+    // until the reload lands.
+    setLoadedConversationId(QString());
+    showConversationMessages(convoId, ReadScheduler::Priority::Background);
+    requestMembers(ReadScheduler::Priority::Background);
 }
 
 void ChatBackend::applyMessageReceived(const QVariantList& args)
@@ -626,25 +1226,25 @@ void ChatBackend::applyMessageReceived(const QVariantList& args)
     const QDateTime when = msToDateTime(ts);
     const QString preview = content.left(kPreviewMaxChars);
 
+    const bool onScreen = convoId == currentConversationId();
+
+    m_editedSinceRead.insert(convoId);
     if (!m_conversationModel->contains(convoId)) {
         // Defensive: ConversationStarted normally lands first with the kind.
-        // Add it now and backfill the kind by re-reading the list (deferred:
-        // this runs inside a module event callback, see deferToEventLoop).
-        m_conversationModel->addConversation(convoId, fallbackDisplayName(convoId), QString(), when, false, preview);
-        deferToEventLoop([this] { rehydrateConversations(); });
-    } else {
-        m_conversationModel->updateLastActivity(convoId, when);
+        // Add it now and backfill the kind by re-reading the list.
+        m_conversationModel->addConversation(convoId, ModuleRecords::fallbackDisplayName(convoId), QString(), when, false, preview);
+        rehydrateConversations(ReadScheduler::Priority::Background);
     }
-    m_conversationModel->updatePreview(convoId, preview);
+    m_conversationModel->applyActivity(convoId, when, preview, !onScreen);
 
-    if (convoId == currentConversationId()) {
-        m_messageModel->addMessage(shortSenderLabel(sender), content, when, false);
+    const MessageItem message{ ModuleRecords::shortSenderLabel(sender), content, when.toMSecsSinceEpoch(), false };
+    m_threadCache.append(convoId, message);
+    if (onScreen) {
+        queueLiveMessage(message);
         // A message from someone not yet on the roster means the group grew;
-        // refetch (deferred: sync module read from inside an event callback).
+        // refetch.
         if (!sender.isEmpty() && !m_memberModel->contains(sender))
-            deferToEventLoop([this] { refreshMembers(); });
-    } else {
-        m_conversationModel->incrementUnread(convoId);
+            requestMembers(ReadScheduler::Priority::Background);
     }
 }
 
@@ -657,15 +1257,17 @@ void ChatBackend::applyMessageSent(const QVariantList& args)
     const QDateTime when = msToDateTime(ts);
     const QString preview = content.left(kPreviewMaxChars);
 
+    m_editedSinceRead.insert(convoId);
     if (!m_conversationModel->contains(convoId)) {
-        m_conversationModel->addConversation(convoId, fallbackDisplayName(convoId), QString(), when, false, preview);
+        m_conversationModel->addConversation(convoId, ModuleRecords::fallbackDisplayName(convoId), QString(), when, false, preview);
     } else {
-        m_conversationModel->updateLastActivity(convoId, when);
+        m_conversationModel->applyActivity(convoId, when, preview, false);
     }
-    m_conversationModel->updatePreview(convoId, preview);
 
+    const MessageItem message{ QStringLiteral("Me"), content, when.toMSecsSinceEpoch(), true };
+    m_threadCache.append(convoId, message);
     if (convoId == currentConversationId())
-        m_messageModel->addMessage(QStringLiteral("Me"), content, when, true);
+        queueLiveMessage(message);
 }
 
 void ChatBackend::applyConversationCreated(const QVariantList& args)
@@ -678,9 +1280,10 @@ void ChatBackend::applyConversationCreated(const QVariantList& args)
     const QString name = args.value(4).toString();
     const QString description = args.value(5).toString();
     const QString displayName =
-        name.isEmpty() ? fallbackDisplayName(convoId, peerLabel, isGroup) : name;
+        name.isEmpty() ? ModuleRecords::fallbackDisplayName(convoId, peerLabel, isGroup) : name;
     const QDateTime now = QDateTime::currentDateTime();
 
+    m_editedSinceRead.insert(convoId);
     if (!m_conversationModel->contains(convoId)) {
         m_conversationModel->addConversation(convoId, displayName, description, now, isGroup, QString());
     } else {
@@ -690,10 +1293,9 @@ void ChatBackend::applyConversationCreated(const QVariantList& args)
     }
 
     // Open a conversation we just created, so creating a chat or group lands
-    // the user in it. Deferred: selectConversation makes a synchronous module
-    // read and this runs inside a module event callback (see deferToEventLoop).
+    // the user in it.
     if (isOutgoing) {
-        deferToEventLoop([this, convoId] { selectConversation(convoId); });
+        selectConversation(convoId);
     } else if (convoId != currentConversationId()) {
         // Being invited comes with no message of its own, so the unread badge is
         // the only thing marking the new row as unseen.
@@ -703,27 +1305,40 @@ void ChatBackend::applyConversationCreated(const QVariantList& args)
 
 void ChatBackend::applyConversationUpdated(const QVariantList& args)
 {
-    const QString convoId = args.value(0).toString();
-    // Cheapest correct option: refresh the whole list (the read is cheap and
-    // conversation counts are small). Deferred — this runs inside a module event
-    // callback (see deferToEventLoop).
-    deferToEventLoop([this, convoId] {
-        rehydrateConversations();
-        // A group update (e.g. a member added) may have grown the roster of the
-        // conversation on screen; refetch it.
-        if (convoId == currentConversationId() && m_conversationModel->isGroupFor(convoId))
-            refreshMembers();
-    });
+    // Gathered rather than acted on: a burst of updates is one list read and at
+    // most one roster read once it is over. The timer is not restarted by each
+    // event, so a steady stream still refreshes every window.
+    m_updatedConversations.insert(args.value(0).toString());
+    ++m_foldedUpdates;
+    if (!m_conversationRefresh->isActive())
+        m_conversationRefresh->start();
+}
+
+void ChatBackend::refreshUpdatedConversations()
+{
+    const QSet<QString> updated = std::exchange(m_updatedConversations, {});
+    const int folded = std::exchange(m_foldedUpdates, 0);
+    if (folded == 0) return;
+    qInfo().noquote() << QStringLiteral("chat_ui: conversation list refresh for %1 updates to %2 conversations")
+                             .arg(folded)
+                             .arg(updated.size());
+
+    // The read is cheap and conversation counts are small, so the whole list
+    // is read again and reconciled.
+    rehydrateConversations(ReadScheduler::Priority::Background);
+    // A group update (e.g. a member added) may have grown the roster of the
+    // conversation on screen; refetch it.
+    const QString convoId = currentConversationId();
+    if (updated.contains(convoId) && m_conversationModel->isGroupFor(convoId))
+        requestMembers(ReadScheduler::Priority::Background);
 }
 
 void ChatBackend::applyMembersChanged(const QVariantList& args)
 {
     const QString convoId = args.value(0).toString();
     // A commit changed this group's roster; refetch it if it is on screen.
-    deferToEventLoop([this, convoId] {
-        if (convoId == currentConversationId() && m_conversationModel->isGroupFor(convoId))
-            refreshMembers();
-    });
+    if (convoId == currentConversationId() && m_conversationModel->isGroupFor(convoId))
+        requestMembers(ReadScheduler::Priority::Background);
 }
 
 void ChatBackend::applyConversationDeleted(const QVariantList& args)
@@ -731,15 +1346,21 @@ void ChatBackend::applyConversationDeleted(const QVariantList& args)
     const QString convoId = args.value(0).toString();
     if (convoId.isEmpty()) return;
 
+    m_deletedSinceRead.insert(convoId);
     m_conversationModel->removeConversation(convoId);
+    m_threadCache.remove(convoId);
+    if (convoId == m_prefetchingConversationId)
+        cancelPrefetch();
     if (convoId == currentConversationId()) {
         setCurrentConversationId(QString());
         setLoadedConversationId(QString());
         syncCurrentConversationMeta();
+        m_pendingLiveMessages.clear();
+        cancelThreadDecode();
         m_messageModel->clear();
         // The roster goes with the conversation. Reached with no current
-        // conversation, refreshMembers clears it without a module read.
-        refreshMembers();
+        // conversation, requestMembers clears it without a module read.
+        requestMembers(ReadScheduler::Priority::Background);
     }
 }
 
@@ -753,15 +1374,3 @@ QString ChatBackend::peerAddressOf(const QVector<MemberItem>& members, bool isGr
     }
     return {};
 }
-
-QString ChatBackend::fallbackDisplayName(const QString& convoId, const QString& peerLabel,
-                                         bool isGroup)
-{
-    const QString label = peerLabel.isEmpty() ? Identity::shortLabel(convoId) : peerLabel;
-    return (isGroup ? QStringLiteral("Group ") : QStringLiteral("DM ")) + label;
-}
-
-QString ChatBackend::shortSenderLabel(const QString& sender)
-{
-    return sender.isEmpty() ? QStringLiteral("Peer") : Identity::shortLabel(sender);
-}
@@ -1,27 +1,33 @@
 #ifndef CHAT_BACKEND_H
 #define CHAT_BACKEND_H
 
+#include <QFutureWatcher>
 #include <QObject>
-#include <QSortFilterProxyModel>
+#include <QSet>
 #include <QString>
 #include <QTimer>
 #include <QVariantList>
-#include <functional>
 #include "rep_ChatBackend_source.h"
 #include "logos_ui_plugin_context.h"
+#include "ConversationFilterModel.h"
 #include "ConversationListModel.h"
 #include "MessageListModel.h"
 #include "MemberListModel.h"
+#include "ReadScheduler.h"
 #include "ErrorLog.h"
 #include "SessionLogFiles.h"
+#include "ThreadCache.h"
+#include "UnreadStore.h"
 
 class ChatBackend : public ChatBackendSimpleSource,
                     public LogosUiPluginContext
 {
     Q_OBJECT
-    // The conversation model reaches QML through a recency proxy, so the list is
-    // sorted newest-first; the base type is what the host remotes to the replica.
+    // The conversation model keeps its rows newest-first itself; the base type
+    // is what the host remotes to the replica.
     Q_PROPERTY(QAbstractItemModel* conversationModel READ conversationModel CONSTANT)
+    // The conversations matching setConversationFilter's query; empty without one.
+    Q_PROPERTY(QAbstractItemModel* conversationSearchModel READ conversationSearchModel CONSTANT)
     Q_PROPERTY(MessageListModel* messageModel READ messageModel CONSTANT)
     Q_PROPERTY(MemberListModel* memberModel READ memberModel CONSTANT)
 
@@ -30,6 +36,7 @@ public:
     ~ChatBackend() override;
 
     QAbstractItemModel* conversationModel() const;
+    QAbstractItemModel* conversationSearchModel() const;
     MessageListModel* messageModel() const;
     MemberListModel* memberModel() const;
 
@@ -43,11 +50,12 @@ public slots:
     void addGroupMember(QString conversationId, QString peerAddress) override;
     void sendMessage(QString conversationId, QString content) override;
     void selectConversation(QString conversationId) override;
-    // Reloads the current conversation's roster into memberModel. A synchronous
-    // module read, so never call it from inside a module event callback without
-    // deferToEventLoop.
+    // Asks the module for the current conversation's roster, which lands in
+    // memberModel when it answers.
     void refreshMembers() override;
+    void fetchOlderMessages() override;
     void refreshSessionLogs() override;
+    void setConversationFilter(QString query) override;
 
 private:
     void initialiseModule();
@@ -71,25 +79,73 @@ private:
     // health() has no other return.
     void onHealthAnswer(bool answered);
     void subscribeToEvents();
-    void rehydrateConversations();
-    // Reads this account's own address into the myAddress property. A
-    // synchronous module read, so never call it from inside a module event
-    // callback without deferToEventLoop.
+    // Asks the module for the conversation list and decodes the answer off the
+    // GUI thread; it lands in conversationModel through landDecodedConversations.
+    //
+    // Every read of the module's state is asynchronous, answered on a later
+    // turn of the event loop, and dropped if a later read or a change of
+    // conversation has superseded it. A synchronous QtRO call issued from inside
+    // a module event callback re-enters the replica's socket-read handler while
+    // its read notifier is disabled, and stalls this thread for the call's ~20s
+    // timeout; an asynchronous one returns at once, so any handler may read.
+    // Each goes through m_reads, at the priority of whatever prompted it.
+    void rehydrateConversations(ReadScheduler::Priority priority);
+    void landDecodedConversations();
+    // Records a conversation's new unread count for the next save and in the
+    // totalUnread property.
+    void applyUnreadCount(const QString& convoId, int count);
+    void saveUnreadCounts();
+    // Lists the conversations as the last run left them, from the snapshot in
+    // the directory its logs were in, until the module has been read.
+    void restoreConversationSnapshot();
+    void saveConversationSnapshot();
+    // Asks the module for this account's own address, for the myAddress
+    // property.
     void refreshMyAddress();
     // Pushes the current conversation's group flag, display name, and description
     // as backend properties for the QML view to bind — see the .cpp for why the
     // view can't read them off the model directly.
     void syncCurrentConversationMeta();
-    // Loads a conversation's messages into messageModel. False when the module
-    // could not be read, leaving the model as it was.
-    bool showConversationMessages(const QString& convoId);
-
-    // Runs `work` on the next event-loop turn. A module read (list_conversations/
-    // get_messages) is a synchronous QtRO call; issuing one from inside a module
-    // event callback re-enters the replica's socket-read handler while its read
-    // notifier is disabled, so the reply only lands after the call's ~20s timeout
-    // and the UI thread stalls. Deferring lets the callback return first.
-    void deferToEventLoop(std::function<void()> work);
+    // Loads a conversation's messages into messageModel, the newest page as rows
+    // and the rest held back for fetchOlderMessages. The thread lands once it
+    // has been read and decoded, and sets loadedConversationId then. A failed
+    // read is reported and leaves the model as it was.
+    void showConversationMessages(const QString& convoId, ReadScheduler::Priority priority);
+    // Re-reads the thread on screen and reconciles messageModel with it, in
+    // place: only the messages that changed reach the view. A no-op once the
+    // user has moved on.
+    void revalidateThread(const QString& convoId, ReadScheduler::Priority priority);
+    // Asks the module for a conversation's thread and decodes the answer off
+    // the GUI thread, superseding any read or decode still under way.
+    void loadThread(const QString& convoId, bool reconcile, ReadScheduler::Priority priority);
+    // Reports a thread read that failed; the model keeps what it had, and the
+    // live messages held for the thread join it.
+    void failThreadRead(const QString& reason);
+    // Moves a decoded thread into messageModel, if its conversation is still
+    // the one on screen.
+    void landDecodedThread();
+    void cancelThreadDecode();
+    // Reads ahead, into m_threadCache, the next of the threads the user is
+    // likeliest to open, while the module has nothing else to do. Each lands
+    // through landPrefetchedThread, which asks for the next.
+    void prefetchNext();
+    void landPrefetchedThread();
+    void cancelPrefetch();
+    // Reads the current conversation's roster into memberModel; refreshMembers
+    // at the user's priority.
+    void requestMembers(ReadScheduler::Priority priority);
+    // Puts a roster the module returned into memberModel and the counts.
+    void applyMembers(const QString& convoId, const QVariantList& members);
+    // Refetches what a reconnect may have missed: the lists, and the thread and
+    // roster on screen.
+    void resyncAfterReconnect();
+
+    // Queues a live message for the conversation on screen. A burst (catch-up
+    // after a reconnect, a busy group) would otherwise reach the view and the
+    // replica as one insert per message; queued, it lands as one insert per
+    // flush, in arrival order.
+    void queueLiveMessage(MessageItem message);
+    void flushLiveMessages();
 
     // Event handlers. Each receives the event's positional argument list, in
     // the order declared in chat_module.lidl.
@@ -98,6 +154,9 @@ private:
     void applyMessageSent(const QVariantList& args);
     void applyConversationCreated(const QVariantList& args);
     void applyConversationUpdated(const QVariantList& args);
+    // The conversation_updated events gathered since the last refresh, acted on
+    // as one.
+    void refreshUpdatedConversations();
     void applyMembersChanged(const QVariantList& args);
     void applyConversationDeleted(const QVariantList& args);
 
@@ -105,19 +164,62 @@ private:
     // or when no other account is on it.
     static QString peerAddressOf(const QVector<MemberItem>& members, bool isGroup);
 
-    static QString fallbackDisplayName(const QString& convoId, const QString& peerLabel = QString(),
-                                       bool isGroup = false);
-
-    // Short display form of a message sender; "Peer" when the sender is empty.
-    static QString shortSenderLabel(const QString& sender);
-
     ConversationListModel* m_conversationModel;
-    // Sorts m_conversationModel newest-first for the view; the source keeps
-    // insertion order and every internal edit stays on the source.
-    QSortFilterProxyModel* m_conversationProxy;
+    ConversationFilterModel* m_conversationSearch;
     MessageListModel* m_messageModel;
     MemberListModel* m_memberModel;
 
+    // Live messages for the current conversation, oldest first, waiting for
+    // m_liveFlush to move them into messageModel.
+    QVector<MessageItem> m_pendingLiveMessages;
+    // Live messages flushed onto the screen while a revalidating read was out,
+    // after it was answered: not in what it returns, so handed to the
+    // reconcile too, which would otherwise take them back out.
+    QVector<MessageItem> m_flushedSinceRead;
+    QTimer* m_liveFlush;
+    // Conversations named by conversation_updated since the last refresh, and
+    // how many events named them, until m_conversationRefresh fires.
+    QSet<QString> m_updatedConversations;
+    int m_foldedUpdates = 0;
+    QTimer* m_conversationRefresh;
+    // Threads recently on screen, so switching back to one shows it at once.
+    ThreadCache m_threadCache;
+    // Unread counts as last saved beside the logs, and the timer that saves a
+    // burst of changes as one write.
+    UnreadStore m_unread;
+    QTimer* m_unreadSave;
+    // Where the conversation list is saved, empty until a directory is known,
+    // and the timer that saves a change to it a little later.
+    QString m_snapshotPath;
+    QTimer* m_snapshotSave;
+
+    // The thread being decoded off the GUI thread: whose it is, empty when
+    // none is, and whether it lands by reconcile (a revalidation) rather than
+    // setMessages (a load). Live messages wait in the queue until it lands.
+    QFutureWatcher<QVector<MessageItem>>* m_threadDecode;
+    QString m_decodingConversationId;
+    bool m_decodeReconciles = false;
+    // Bumped by each read asked for, or abandoned, so an answer that arrives
+    // after a later read was asked for is recognised and dropped.
+    quint64 m_threadReads = 0;
+    quint64 m_conversationReads = 0;
+    quint64 m_memberReads = 0;
+    // Every read of the module goes out through here, one at a time and the
+    // user's first.
+    ReadScheduler m_reads;
+    // The conversation list being decoded off the GUI thread. Events edit the
+    // list in place meanwhile, and a read older than an edit would undo it, so
+    // the conversations they touched, and those they deleted, since the read
+    // are noted, and the read gives way to them as it lands.
+    QFutureWatcher<QVector<ConversationItem>>* m_conversationsDecode;
+    QSet<QString> m_editedSinceRead;
+    QSet<QString> m_deletedSinceRead;
+    // Started after the list lands and after each switch, to read ahead once
+    // things have settled; the thread being read ahead, empty when none is.
+    QTimer* m_prefetch;
+    QFutureWatcher<QVector<MessageItem>>* m_prefetchDecode;
+    QString m_prefetchingConversationId;
+
     bool m_moduleInitialised = false;
     // Set once the initial snapshot has loaded; gates the reconnect resync in
     // applyDeliveryState so it doesn't fire during initial setup.
@@ -0,0 +1,199 @@
+#include "ConversationFilterModel.h"
+
+#include "ConversationListModel.h"
+
+#include <QHash>
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+// The positions of a longest strictly rising run through `seq`, which holds
+// no value twice.
+QSet<int> longestRising(const QVector<int>& seq)
+{
+    // tails[k] is where the lowest-ending rising run of length k + 1 ends.
+    QVector<int> tails;
+    QVector<int> before(seq.size(), -1);
+    for (int i = 0; i < seq.size(); ++i) {
+        const auto slot = std::lower_bound(tails.begin(), tails.end(), seq.at(i),
+                                           [&seq](int at, int value) { return seq.at(at) < value; });
+        if (slot != tails.begin())
+            before[i] = *std::prev(slot);
+        if (slot == tails.end())
+            tails.append(i);
+        else
+            *slot = i;
+    }
+    QSet<int> run;
+    for (int i = tails.isEmpty() ? -1 : tails.last(); i >= 0; i = before.at(i))
+        run.insert(i);
+    return run;
+}
+
+} // namespace
+
+ConversationFilterModel::ConversationFilterModel(ConversationListModel* source, QObject* parent)
+    : QAbstractListModel(parent)
+    , m_source(source)
+{
+    // Rows coming, going or moving in the source change which of its rows the
+    // matches are, even when the matches themselves stay.
+    connect(m_source, &QAbstractItemModel::rowsInserted, this, [this] { refilter(); });
+    connect(m_source, &QAbstractItemModel::rowsRemoved, this, [this] { refilter(); });
+    connect(m_source, &QAbstractItemModel::rowsMoved, this, [this] { refilter(); });
+    connect(m_source, &QAbstractItemModel::layoutChanged, this, [this] { refilter(); });
+    connect(m_source, &QAbstractItemModel::modelReset, this, [this] { refilter(); });
+    connect(m_source, &QAbstractItemModel::dataChanged, this, &ConversationFilterModel::forwardDataChanged);
+}
+
+int ConversationFilterModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) return 0;
+    return m_rows.size();
+}
+
+QVariant ConversationFilterModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size())
+        return {};
+    return m_source->data(m_source->index(m_rows.at(index.row())), role);
+}
+
+QHash<int, QByteArray> ConversationFilterModel::roleNames() const
+{
+    return m_source->roleNames();
+}
+
+QString ConversationFilterModel::query() const
+{
+    return m_query;
+}
+
+void ConversationFilterModel::setQuery(const QString& query)
+{
+    if (m_query == query) return;
+    m_query = query;
+    refilter();
+}
+
+QSet<QString> ConversationFilterModel::refilter()
+{
+    QVector<int> rows;
+    QHash<QString, int> sourceRow;
+    const QSet<QString> matched = m_source->search(m_query);
+    rows.reserve(matched.size());
+    sourceRow.reserve(matched.size());
+    for (const QString& id : matched) {
+        const int row = m_source->indexOf(id);
+        rows.append(row);
+        sourceRow.insert(id, row);
+    }
+    std::sort(rows.begin(), rows.end());
+    QStringList ids;
+    ids.reserve(rows.size());
+    for (int row : std::as_const(rows))
+        ids.append(m_source->data(m_source->index(row), ConversationListModel::ConversationIdRole).toString());
+
+    if (ids == m_ids) {
+        // The same conversations in the same order, at other source rows.
+        m_rows = std::move(rows);
+        return {};
+    }
+
+    // The rows listed already are read from where the source has them now;
+    // those about to go, from nowhere.
+    for (int i = 0; i < m_ids.size(); ++i)
+        m_rows[i] = sourceRow.value(m_ids.at(i), -1);
+
+    // Those no longer matching go first, a contiguous run at a time and from
+    // the bottom up, so the rows still to be looked at keep their indices.
+    for (int end = m_ids.size() - 1; end >= 0;) {
+        if (sourceRow.contains(m_ids.at(end))) {
+            --end;
+            continue;
+        }
+        int start = end;
+        while (start > 0 && !sourceRow.contains(m_ids.at(start - 1)))
+            --start;
+        beginRemoveRows(QModelIndex(), start, end);
+        m_ids.remove(start, end - start + 1);
+        m_rows.remove(start, end - start + 1);
+        endRemoveRows();
+        end = start - 1;
+    }
+
+    // Those still matching are put in the source's order by moving the fewest:
+    // the longest run already in order stays, and each of the rest goes, in
+    // the new order, just below the one it now follows.
+    const QSet<QString> kept(m_ids.cbegin(), m_ids.cend());
+    QHash<QString, int> keptOrder;
+    QStringList order;
+    for (const QString& id : std::as_const(ids)) {
+        if (!kept.contains(id)) continue;
+        keptOrder.insert(id, order.size());
+        order.append(id);
+    }
+    QVector<int> ranks;
+    ranks.reserve(m_ids.size());
+    for (const QString& id : std::as_const(m_ids))
+        ranks.append(keptOrder.value(id));
+    QSet<QString> settled;
+    for (int position : longestRising(ranks))
+        settled.insert(m_ids.at(position));
+    for (int k = 0; k < order.size(); ++k) {
+        if (settled.contains(order.at(k))) continue;
+        const int from = static_cast<int>(m_ids.indexOf(order.at(k)));
+        int to = 0;
+        if (k > 0) {
+            const int after = static_cast<int>(m_ids.indexOf(order.at(k - 1)));
+            to = after < from ? after + 1 : after;
+        }
+        if (to == from) continue;
+        beginMoveRows(QModelIndex(), from, from, QModelIndex(), to > from ? to + 1 : to);
+        m_ids.move(from, to);
+        m_rows.move(from, to);
+        endMoveRows();
+    }
+
+    // New matches go in where the source lists them, a contiguous run at a time.
+    QSet<QString> inserted;
+    for (int i = 0; i < ids.size();) {
+        if (kept.contains(ids.at(i))) {
+            ++i;
+            continue;
+        }
+        int run = 1;
+        while (i + run < ids.size() && !kept.contains(ids.at(i + run)))
+            ++run;
+        beginInsertRows(QModelIndex(), i, i + run - 1);
+        for (int j = i; j < i + run; ++j) {
+            m_ids.insert(j, ids.at(j));
+            m_rows.insert(j, rows.at(j));
+            inserted.insert(ids.at(j));
+        }
+        endInsertRows();
+        i += run;
+    }
+    return inserted;
+}
+
+void ConversationFilterModel::forwardDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight,
+                                                 const QList<int>& roles)
+{
+    // Text the index reads may have changed, so the matches may have too. A
+    // row that only now matches went in with its data as it is.
+    QSet<QString> inserted;
+    if (roles.isEmpty() || roles.contains(ConversationListModel::DisplayNameRole)
+        || roles.contains(ConversationListModel::DescriptionRole)
+        || roles.contains(ConversationListModel::PreviewRole))
+        inserted = refilter();
+
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        const auto found = std::lower_bound(m_rows.cbegin(), m_rows.cend(), row);
+        if (found == m_rows.cend() || *found != row) continue;
+        const int filtered = static_cast<int>(found - m_rows.cbegin());
+        if (inserted.contains(m_ids.at(filtered))) continue;
+        emit dataChanged(index(filtered), index(filtered), roles);
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef CONVERSATION_FILTER_MODEL_H
+#define CONVERSATION_FILTER_MODEL_H
+
+#include <QAbstractListModel>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class ConversationListModel;
+
+// The conversations matching a search, in the source's recency order, with
+// the source's roles. The matches come from the source's word index rather
+// than from testing each row, so a keystroke costs what it matches. Empty
+// while there is no query: the view lists the source itself then, and this
+// model holds nothing.
+class ConversationFilterModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit ConversationFilterModel(ConversationListModel* source, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    QString query() const;
+    void setQuery(const QString& query);
+
+private:
+    // Matches the query again and tells the view what changed in what it
+    // lists as row removals, moves and inserts, never a reset: the view keeps
+    // its scroll and selection through a keystroke or a new message. Returns
+    // the ids it inserted.
+    QSet<QString> refilter();
+    void forwardDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight,
+                            const QList<int>& roles);
+
+    ConversationListModel* m_source;
+    QString m_query;
+    // The matches' ids and source rows, in source order.
+    QStringList m_ids;
+    QVector<int> m_rows;
+};
+
+#endif
@@ -5,10 +5,35 @@
 
 #include <QDate>
 #include <QLocale>
+#include <QStringList>
+#include <QTimer>
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// Past midnight by this much before the activity labels are redone, so a timer
+// that fires a touch early does not label the old day's times again.
+constexpr int kRolloverSlackMs = 1000;
+
+// Whether `item` is listed above the row with `lastActivity`, placed at
+// `placed`.
+bool listedAbove(const ConversationItem& item, const QDateTime& lastActivity, quint64 placed)
+{
+    if (item.lastActivity != lastActivity)
+        return item.lastActivity > lastActivity;
+    return item.placed > placed;
+}
+
+} // namespace
 
 ConversationListModel::ConversationListModel(QObject* parent)
     : QAbstractListModel(parent)
+    , m_dayRollover(new QTimer(this))
 {
+    m_dayRollover->setSingleShot(true);
+    connect(m_dayRollover, &QTimer::timeout, this, [this] { rollOverDay(); });
+    scheduleDayRollover();
 }
 
 int ConversationListModel::rowCount(const QModelIndex& parent) const
@@ -27,13 +52,13 @@ QVariant ConversationListModel::data(const QModelIndex& index, int role) const
     case ConversationIdRole:      return item.conversationId;
     case DisplayNameRole:         return item.displayName;
     case LastActivityRole:        return item.lastActivity;
-    case LastActivityDisplayRole: return formatLastActivity(item.lastActivity);
+    case LastActivityDisplayRole: return item.lastActivityDisplay;
     case UnreadCountRole:         return item.unreadCount;
     case IsGroupRole:             return item.isGroup;
     case PreviewRole:             return item.preview;
     case DescriptionRole:         return item.description;
-    case AvatarInitialsRole:      return Identity::initials(item.conversationId);
-    case AvatarRampRole:          return Identity::avatarRamp(Identity::shortLabel(item.conversationId));
+    case AvatarInitialsRole:      return item.avatarInitials;
+    case AvatarRampRole:          return item.avatarRamp;
     default:                      return {};
     }
 }
@@ -60,8 +85,13 @@ void ConversationListModel::addConversation(const QString& id, const QString& di
 {
     if (contains(id)) return;
 
-    beginInsertRows(QModelIndex(), m_items.size(), m_items.size());
-    m_items.append({ id, displayName, description, lastActivity, 0, isGroup, preview });
+    ConversationItem item{ id, displayName, description, lastActivity, 0, isGroup, preview };
+    derive(item);
+    place(item);
+    const int row = rowFor(lastActivity);
+    beginInsertRows(QModelIndex(), row, row);
+    m_items.insert(row, std::move(item));
+    indexForSearch(m_items.at(row));
     endInsertRows();
 }
 
@@ -72,6 +102,7 @@ void ConversationListModel::updateDisplayName(const QString& id, const QString&
 
     if (m_items[idx].displayName == displayName) return;
     m_items[idx].displayName = displayName;
+    indexForSearch(m_items.at(idx));
     emit dataChanged(index(idx), index(idx), { DisplayNameRole });
 }
 
@@ -82,6 +113,7 @@ void ConversationListModel::updateDescription(const QString& id, const QString&
 
     if (m_items[idx].description == description) return;
     m_items[idx].description = description;
+    indexForSearch(m_items.at(idx));
     emit dataChanged(index(idx), index(idx), { DescriptionRole });
 }
 
@@ -92,6 +124,7 @@ void ConversationListModel::updatePreview(const QString& id, const QString& prev
 
     if (m_items[idx].preview == preview) return;
     m_items[idx].preview = preview;
+    indexForSearch(m_items.at(idx));
     emit dataChanged(index(idx), index(idx), { PreviewRole });
 }
 
@@ -101,6 +134,9 @@ void ConversationListModel::updateLastActivity(const QString& id, const QDateTim
     if (idx < 0) return;
 
     m_items[idx].lastActivity = lastActivity;
+    m_items[idx].lastActivityDisplay = formatLastActivity(lastActivity);
+    // Moved first, so a listener reading the row finds it where it belongs.
+    idx = reposition(idx);
     emit dataChanged(index(idx), index(idx), { LastActivityRole, LastActivityDisplayRole });
 }
 
@@ -110,37 +146,54 @@ void ConversationListModel::incrementUnread(const QString& id)
     if (idx < 0) return;
 
     m_items[idx].unreadCount++;
+    ++m_totalUnread;
     emit dataChanged(index(idx), index(idx), { UnreadCountRole });
+    emit unreadCountChanged(id, m_items.at(idx).unreadCount);
 }
 
-void ConversationListModel::clearUnread(const QString& id)
+void ConversationListModel::applyActivity(const QString& id, const QDateTime& lastActivity,
+                                          const QString& preview, bool countUnread)
 {
     int idx = indexOf(id);
     if (idx < 0) return;
 
-    if (m_items[idx].unreadCount == 0) return;
-    m_items[idx].unreadCount = 0;
-    emit dataChanged(index(idx), index(idx), { UnreadCountRole });
-}
-
-QHash<QString, int> ConversationListModel::unreadCounts() const
-{
-    QHash<QString, int> counts;
-    for (const auto& item : m_items) {
-        if (item.unreadCount > 0)
-            counts.insert(item.conversationId, item.unreadCount);
+    ConversationItem& item = m_items[idx];
+    QList<int> roles;
+    const bool moved = item.lastActivity != lastActivity;
+    if (moved) {
+        item.lastActivity = lastActivity;
+        item.lastActivityDisplay = formatLastActivity(lastActivity);
+        roles << LastActivityRole << LastActivityDisplayRole;
+    }
+    if (item.preview != preview) {
+        item.preview = preview;
+        indexForSearch(item);
+        roles << PreviewRole;
     }
-    return counts;
+    if (countUnread) {
+        item.unreadCount++;
+        ++m_totalUnread;
+        roles << UnreadCountRole;
+    }
+    if (roles.isEmpty()) return;
+    const int unread = item.unreadCount;
+    if (moved)
+        idx = reposition(idx);
+    emit dataChanged(index(idx), index(idx), roles);
+    if (countUnread)
+        emit unreadCountChanged(id, unread);
 }
 
-void ConversationListModel::restoreUnreadCounts(const QHash<QString, int>& counts)
+void ConversationListModel::clearUnread(const QString& id)
 {
-    for (int i = 0; i < m_items.size(); ++i) {
-        const int count = counts.value(m_items.at(i).conversationId, 0);
-        if (count == 0 || m_items[i].unreadCount == count) continue;
-        m_items[i].unreadCount = count;
-        emit dataChanged(index(i), index(i), { UnreadCountRole });
-    }
+    int idx = indexOf(id);
+    if (idx < 0) return;
+
+    if (m_items[idx].unreadCount == 0) return;
+    m_totalUnread -= m_items.at(idx).unreadCount;
+    m_items[idx].unreadCount = 0;
+    emit dataChanged(index(idx), index(idx), { UnreadCountRole });
+    emit unreadCountChanged(id, 0);
 }
 
 void ConversationListModel::removeConversation(const QString& id)
@@ -148,17 +201,256 @@ void ConversationListModel::removeConversation(const QString& id)
     int idx = indexOf(id);
     if (idx < 0) return;
 
+    const int unread = m_items.at(idx).unreadCount;
     beginRemoveRows(QModelIndex(), idx, idx);
     m_items.removeAt(idx);
+    m_keys.remove(id);
+    m_search.remove(id);
+    m_totalUnread -= unread;
     endRemoveRows();
+    if (unread > 0)
+        emit unreadCountChanged(id, 0);
+}
+
+void ConversationListModel::reconcile(QVector<ConversationItem> items)
+{
+    QHash<QString, int> fresh;
+    fresh.reserve(items.size());
+    for (int i = 0; i < items.size(); ++i) {
+        if (!fresh.contains(items.at(i).conversationId))
+            fresh.insert(items.at(i).conversationId, i);
+    }
+
+    // Rows the read no longer lists go first, a contiguous run at a time and
+    // from the bottom up, so the rows still to be looked at keep their indices.
+    QStringList forgotten;
+    for (int end = m_items.size() - 1; end >= 0;) {
+        if (fresh.contains(m_items.at(end).conversationId)) {
+            --end;
+            continue;
+        }
+        int start = end;
+        while (start > 0 && !fresh.contains(m_items.at(start - 1).conversationId))
+            --start;
+        beginRemoveRows(QModelIndex(), start, end);
+        for (int row = start; row <= end; ++row) {
+            const ConversationItem& gone = m_items.at(row);
+            m_search.remove(gone.conversationId);
+            if (gone.unreadCount > 0) {
+                m_totalUnread -= gone.unreadCount;
+                forgotten.append(gone.conversationId);
+            }
+        }
+        for (int row = start; row <= end; ++row)
+            m_keys.remove(m_items.at(row).conversationId);
+        m_items.remove(start, end - start + 1);
+        endRemoveRows();
+        end = start - 1;
+    }
+
+    for (const QString& id : std::as_const(forgotten))
+        emit unreadCountChanged(id, 0);
+
+    // Rows both hold are updated in place, each telling the view only the roles
+    // that changed once every row is back in order. The unread count is this
+    // model's own and stays as it is.
+    QSet<QString> moved;
+    int movedRow = -1;
+    QVector<QPair<QString, QList<int>>> changed;
+    for (int row = 0; row < m_items.size(); ++row) {
+        ConversationItem& item = m_items[row];
+        const ConversationItem& read = items.at(fresh.value(item.conversationId));
+        QList<int> roles;
+        if (item.displayName != read.displayName) {
+            item.displayName = read.displayName;
+            roles.append(DisplayNameRole);
+        }
+        if (item.description != read.description) {
+            item.description = read.description;
+            roles.append(DescriptionRole);
+        }
+        if (item.lastActivity != read.lastActivity) {
+            item.lastActivity = read.lastActivity;
+            item.lastActivityDisplay = formatLastActivity(item.lastActivity);
+            roles << LastActivityRole << LastActivityDisplayRole;
+            moved.insert(item.conversationId);
+            movedRow = row;
+        }
+        if (item.isGroup != read.isGroup) {
+            item.isGroup = read.isGroup;
+            roles.append(IsGroupRole);
+        }
+        if (item.preview != read.preview) {
+            item.preview = read.preview;
+            roles.append(PreviewRole);
+        }
+        if (roles.isEmpty())
+            continue;
+        if (roles.contains(DisplayNameRole) || roles.contains(DescriptionRole) || roles.contains(PreviewRole))
+            indexForSearch(item);
+        changed.append({ item.conversationId, roles });
+    }
+    // A single row out of place has settled neighbours to search; with several,
+    // each one's neighbours may still be out of place themselves.
+    if (moved.size() == 1)
+        reposition(movedRow);
+    else if (moved.size() > 1)
+        resort(moved);
+    for (const auto& [id, roles] : std::as_const(changed)) {
+        const int row = indexOf(id);
+        emit dataChanged(index(row), index(row), roles);
+    }
+
+    // Conversations new to the list go in where their activity puts them,
+    // newest first, a run bound for the same place as one insert: a first
+    // load is a single insert of the lot.
+    QVector<ConversationItem> added;
+    for (int i = 0; i < items.size(); ++i) {
+        const QString& id = items.at(i).conversationId;
+        if (fresh.value(id) == i && !m_keys.contains(id))
+            added.append(std::move(items[i]));
+    }
+    std::stable_sort(added.begin(), added.end(), [](const ConversationItem& left, const ConversationItem& right) {
+        return left.lastActivity > right.lastActivity;
+    });
+    // Placed from the bottom up, so of those as recent as each other the one
+    // listed first in the read stays first.
+    for (auto item = added.rbegin(); item != added.rend(); ++item)
+        place(*item);
+    QStringList counted;
+    for (int next = 0; next < added.size();) {
+        const int row = rowFor(added.at(next).lastActivity);
+        int run = 1;
+        while (next + run < added.size()
+               && (row == m_items.size() || added.at(next + run).lastActivity >= m_items.at(row).lastActivity))
+            ++run;
+        beginInsertRows(QModelIndex(), row, row + run - 1);
+        for (int i = 0; i < run; ++i) {
+            ConversationItem& item = added[next + i];
+            item.unreadCount = qMax(item.unreadCount, 0);
+            derive(item);
+            if (item.unreadCount > 0) {
+                m_totalUnread += item.unreadCount;
+                counted.append(item.conversationId);
+            }
+            m_items.insert(row + i, std::move(item));
+            indexForSearch(m_items.at(row + i));
+        }
+        endInsertRows();
+        next += run;
+    }
+    for (const QString& id : std::as_const(counted))
+        emit unreadCountChanged(id, m_items.at(indexOf(id)).unreadCount);
 }
 
 void ConversationListModel::clear()
 {
     if (m_items.isEmpty()) return;
+    QStringList forgotten;
+    for (const ConversationItem& item : std::as_const(m_items)) {
+        if (item.unreadCount > 0)
+            forgotten.append(item.conversationId);
+    }
     beginResetModel();
     m_items.clear();
+    m_keys.clear();
+    m_search.clear();
+    m_totalUnread = 0;
     endResetModel();
+    for (const QString& id : std::as_const(forgotten))
+        emit unreadCountChanged(id, 0);
+}
+
+int ConversationListModel::rowFor(const QDateTime& lastActivity) const
+{
+    // Above the rows as recent as it, as the latest to have that activity.
+    const auto row = std::partition_point(m_items.cbegin(), m_items.cend(), [&](const ConversationItem& item) {
+        return item.lastActivity > lastActivity;
+    });
+    return static_cast<int>(row - m_items.cbegin());
+}
+
+int ConversationListModel::reposition(int from)
+{
+    // Placed afresh, it goes above the rows as recent as it. The rows above
+    // and the rows below are each in order, so a binary search of the side it
+    // has to go to finds its place.
+    place(m_items[from]);
+    const QDateTime when = m_items.at(from).lastActivity;
+    int to = from;
+    if (from > 0 && m_items.at(from - 1).lastActivity <= when) {
+        to = static_cast<int>(std::partition_point(m_items.cbegin(), m_items.cbegin() + from,
+                                                   [&](const ConversationItem& item) {
+                                                       return item.lastActivity > when;
+                                                   }) - m_items.cbegin());
+    } else if (from + 1 < m_items.size() && m_items.at(from + 1).lastActivity > when) {
+        to = static_cast<int>(std::partition_point(m_items.cbegin() + from + 1, m_items.cend(),
+                                                   [&](const ConversationItem& item) {
+                                                       return item.lastActivity > when;
+                                                   }) - m_items.cbegin()) - 1;
+    }
+    if (to == from) return from;
+
+    // beginMoveRows names the row the moved one goes above, counted before it
+    // leaves, hence the one past `to` on the way down.
+    beginMoveRows(QModelIndex(), from, from, QModelIndex(), to > from ? to + 1 : to);
+    m_items.move(from, to);
+    endMoveRows();
+    return to;
+}
+
+void ConversationListModel::resort(const QSet<QString>& moved)
+{
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+    const QModelIndexList before = persistentIndexList();
+    QStringList held;
+    held.reserve(before.size());
+    for (const QModelIndex& persistent : before)
+        held.append(m_items.at(persistent.row()).conversationId);
+
+    // Placed from the bottom up, so of the moved rows as recent as each other
+    // the higher stays higher.
+    for (int row = m_items.size() - 1; row >= 0; --row) {
+        if (moved.contains(m_items.at(row).conversationId))
+            place(m_items[row]);
+    }
+    std::sort(m_items.begin(), m_items.end(), [](const ConversationItem& left, const ConversationItem& right) {
+        return listedAbove(left, right.lastActivity, right.placed);
+    });
+
+    QModelIndexList after;
+    after.reserve(before.size());
+    for (int i = 0; i < before.size(); ++i)
+        after.append(index(indexOf(held.at(i)), before.at(i).column()));
+    changePersistentIndexList(before, after);
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
+void ConversationListModel::indexForSearch(const ConversationItem& item)
+{
+    m_search.set(item.conversationId, { item.displayName, item.description, item.conversationId, item.preview });
+}
+
+QSet<QString> ConversationListModel::search(const QString& query) const
+{
+    return m_search.match(query);
+}
+
+QStringList ConversationListModel::likelyNext(int count) const
+{
+    QStringList ids;
+    for (int row = 0; row < m_items.size(); ++row) {
+        const ConversationItem& item = m_items.at(row);
+        if (row < count || item.unreadCount > 0)
+            ids.append(item.conversationId);
+    }
+    return ids;
+}
+
+void ConversationListModel::place(ConversationItem& item)
+{
+    item.placed = ++m_placed;
+    m_keys.insert(item.conversationId, { item.lastActivity, item.placed });
 }
 
 bool ConversationListModel::contains(const QString& id) const
@@ -168,11 +460,23 @@ bool ConversationListModel::contains(const QString& id) const
 
 int ConversationListModel::indexOf(const QString& id) const
 {
-    for (int i = 0; i < m_items.size(); ++i) {
-        if (m_items[i].conversationId == id)
-            return i;
-    }
-    return -1;
+    const auto key = m_keys.constFind(id);
+    if (key == m_keys.cend())
+        return -1;
+    const auto row = std::partition_point(m_items.cbegin(), m_items.cend(), [&](const ConversationItem& item) {
+        return listedAbove(item, key->lastActivity, key->placed);
+    });
+    return row != m_items.cend() && row->conversationId == id ? static_cast<int>(row - m_items.cbegin()) : -1;
+}
+
+const QVector<ConversationItem>& ConversationListModel::conversations() const
+{
+    return m_items;
+}
+
+int ConversationListModel::totalUnread() const
+{
+    return m_totalUnread;
 }
 
 QString ConversationListModel::displayNameFor(const QString& id) const
@@ -207,3 +511,35 @@ QString ConversationListModel::formatLastActivity(const QDateTime& lastActivity)
         return tr("Yesterday");
     return locale.toString(date, QLocale::ShortFormat);
 }
+
+void ConversationListModel::derive(ConversationItem& item) const
+{
+    item.avatarInitials = Identity::initials(item.conversationId);
+    item.avatarRamp = Identity::avatarRamp(Identity::shortLabel(item.conversationId));
+    item.lastActivityDisplay = formatLastActivity(item.lastActivity);
+}
+
+void ConversationListModel::scheduleDayRollover()
+{
+    const QDateTime now = QDateTime::currentDateTime();
+    const qint64 untilMidnight = now.msecsTo(now.date().addDays(1).startOfDay());
+    m_dayRollover->start(static_cast<int>(untilMidnight) + kRolloverSlackMs);
+}
+
+void ConversationListModel::rollOverDay()
+{
+    int first = -1;
+    int last = -1;
+    for (int row = 0; row < m_items.size(); ++row) {
+        ConversationItem& item = m_items[row];
+        QString label = formatLastActivity(item.lastActivity);
+        if (label == item.lastActivityDisplay) continue;
+        item.lastActivityDisplay = std::move(label);
+        if (first < 0) first = row;
+        last = row;
+    }
+    // Newest first, so the rows that changed are the top few.
+    if (first >= 0)
+        emit dataChanged(index(first), index(last), { LastActivityDisplayRole });
+    scheduleDayRollover();
+}
@@ -4,9 +4,15 @@
 #include <QAbstractListModel>
 #include <QDateTime>
 #include <QHash>
+#include <QSet>
 #include <QString>
+#include <QStringList>
 #include <QVector>
 
+#include "ConversationSearchIndex.h"
+
+class QTimer;
+
 struct ConversationItem {
     QString conversationId;
     QString displayName;
@@ -16,7 +22,19 @@ struct ConversationItem {
     bool isGroup = false;
     // Truncated last-message content shown as a list preview.
     QString preview;
+
+    // Derived by the model as the row goes in or its activity changes, so a
+    // scrolling view reads them rather than has them worked out per fetch.
+    QString avatarInitials;
+    int avatarRamp = 0;
+    QString lastActivityDisplay;
+    // When the model last placed the row, counting up: of rows as recent as
+    // each other, the one placed latest is listed first.
+    quint64 placed = 0;
 };
+// Every member is, so a row going in at the top moves those below it as one
+// block of memory rather than one at a time.
+Q_DECLARE_TYPEINFO(ConversationItem, Q_RELOCATABLE_TYPE);
 
 class ConversationListModel : public QAbstractListModel
 {
@@ -30,9 +48,9 @@ public:
         UnreadCountRole,
         IsGroupRole,
         // Relative last-activity label ("14:03" today, "Yesterday", else a short
-        // date). Computed when the activity changes, so an app left idle keeps
-        // yesterday's label until the next activity or a rehydrate; there is no
-        // day-tick timer.
+        // date). Computed when the activity changes, and for every row again
+        // just past local midnight, so an app left open overnight relabels
+        // today's times as "Yesterday".
         LastActivityDisplayRole,
         // Truncated last-message content for the list preview.
         PreviewRole,
@@ -56,18 +74,44 @@ public:
     void updateDisplayName(const QString& id, const QString& displayName);
     void updateDescription(const QString& id, const QString& description);
     void updatePreview(const QString& id, const QString& preview);
+    // Also moves the row to where its new activity puts it.
     void updateLastActivity(const QString& id, const QDateTime& lastActivity);
     void incrementUnread(const QString& id);
+    // What one message does to its conversation's row, in one pass: the last
+    // activity and preview become the message's, and the unread count goes up
+    // by one when `countUnread`. The view is told once, with every role that
+    // changed, rather than once per field.
+    void applyActivity(const QString& id, const QDateTime& lastActivity, const QString& preview,
+                       bool countUnread);
     void clearUnread(const QString& id);
-    // Unread counts by conversation id, and their restoration onto a rebuilt
-    // list: the module does not track them, so a rebuild would drop them.
-    QHash<QString, int> unreadCounts() const;
-    void restoreUnreadCounts(const QHash<QString, int>& counts);
     void removeConversation(const QString& id);
+    // Brings the list in line with a fresh read of it, matched by id: a row the
+    // read lacks is removed, one it adds goes in where its activity puts it, one
+    // whose activity changed moves, and one both hold is told only the roles
+    // that changed, so an update to one conversation touches one row and no
+    // delegate is torn down. Unread counts are this model's own, as
+    // the module does not track them: a row already listed keeps its count, and
+    // one the read adds starts at the count its item carries. A conversation
+    // listed twice keeps its first entry.
+    void reconcile(QVector<ConversationItem> items);
     void clear();
     bool contains(const QString& id) const;
 
     int indexOf(const QString& id) const;
+    // The rows, in list order.
+    const QVector<ConversationItem>& conversations() const;
+
+    // The unread counts of every row, summed as they change.
+    int totalUnread() const;
+
+    // The ids of the conversations whose display name, description, id or
+    // preview has a word starting with each word of `query`.
+    QSet<QString> search(const QString& query) const;
+
+    // The conversations the user is likeliest to open next, likeliest first:
+    // the first `count` in the list, then any further down with unread
+    // messages.
+    QStringList likelyNext(int count) const;
 
     // Display name for a conversation id, or empty if unknown.
     Q_INVOKABLE QString displayNameFor(const QString& id) const;
@@ -78,11 +122,59 @@ public:
     // Whether a conversation is a group; false for a direct or unknown id.
     Q_INVOKABLE bool isGroupFor(const QString& id) const;
 
+signals:
+    // A row's unread count changed, or a row with unread messages left the list,
+    // as zero. totalUnread() is up to date by then.
+    void unreadCountChanged(const QString& id, int count);
+
 private:
     // Relative label for the last-activity timestamp (see LastActivityDisplayRole).
     QString formatLastActivity(const QDateTime& lastActivity) const;
+    // Fills in a row's derived fields from its id and activity.
+    void derive(ConversationItem& item) const;
+    // Redoes the activity labels at local midnight, when a time becomes
+    // "Yesterday" and "Yesterday" a date, and tells the view the rows changed.
+    void scheduleDayRollover();
+    void rollOverDay();
+
+    // Where a conversation with this last activity goes: above every row less
+    // recent, and above those as recent too.
+    int rowFor(const QDateTime& lastActivity) const;
+    // Moves a row whose activity changed to where it now belongs, as one move,
+    // and returns where that is. Only the one row may be out of place.
+    int reposition(int row);
+    // Puts every row back in order when several are out of place at once, as
+    // one layout change. A row in `moved` goes above the rows as recent as it,
+    // as reposition would put it.
+    void resort(const QSet<QString>& moved);
+    // Stamps the row as placed now and files where that puts it in m_keys.
+    void place(ConversationItem& item);
+    // Files a row's searchable text in m_search, before the view hears of the
+    // change, so a filter refreshed by it finds the new text.
+    void indexForSearch(const ConversationItem& item);
+
+    // Where a row sorts: by activity, most recent first, then most recently
+    // placed first. No two rows share one.
+    struct RowKey {
+        QDateTime lastActivity;
+        quint64 placed = 0;
+    };
 
+    // Most recent activity first, the order the view lists them in: kept here
+    // as each row goes in or its activity changes, rather than by a sorting
+    // proxy that compares every row again on each update.
     QVector<ConversationItem> m_items;
+    // The sort key by conversation id. Every per-id call goes through indexOf,
+    // and an incoming message makes several, so a list of thousands is not
+    // scanned for each: the key finds the row by binary search. A row number
+    // would be O(1) to read but not to keep, as every row going in, out or
+    // moving shifts the numbers of those between; a key changes only with its
+    // own row, so keeping it is O(1) too.
+    QHash<QString, RowKey> m_keys;
+    quint64 m_placed = 0;
+    ConversationSearchIndex m_search;
+    int m_totalUnread = 0;
+    QTimer* m_dayRollover;
 };
 
 #endif
@@ -0,0 +1,89 @@
+#include "ConversationSearchIndex.h"
+
+#include <algorithm>
+
+void ConversationSearchIndex::set(const QString& id, const QStringList& fields)
+{
+    QSet<QString> fresh;
+    for (const QString& field : fields) {
+        const QStringList found = words(field);
+        for (const QString& word : found)
+            fresh.insert(word);
+    }
+
+    QSet<QString>& filed = m_wordsOf[id];
+    if (filed == fresh)
+        return;
+    // Only the words that came or went touch the postings, so a new preview
+    // costs the words it changed rather than all of them.
+    for (const QString& word : std::as_const(filed)) {
+        if (fresh.contains(word)) continue;
+        const auto posting = m_postings.find(word);
+        posting->remove(id);
+        if (posting->isEmpty())
+            m_postings.erase(posting);
+    }
+    for (const QString& word : std::as_const(fresh)) {
+        if (!filed.contains(word))
+            m_postings[word].insert(id);
+    }
+    filed = std::move(fresh);
+}
+
+void ConversationSearchIndex::remove(const QString& id)
+{
+    const auto filed = m_wordsOf.constFind(id);
+    if (filed == m_wordsOf.cend())
+        return;
+    for (const QString& word : *filed) {
+        const auto posting = m_postings.find(word);
+        posting->remove(id);
+        if (posting->isEmpty())
+            m_postings.erase(posting);
+    }
+    m_wordsOf.erase(filed);
+}
+
+void ConversationSearchIndex::clear()
+{
+    m_postings.clear();
+    m_wordsOf.clear();
+}
+
+QSet<QString> ConversationSearchIndex::match(const QString& query) const
+{
+    const QStringList prefixes = words(query);
+    QSet<QString> matched;
+    for (int i = 0; i < prefixes.size(); ++i) {
+        const QString& prefix = prefixes.at(i);
+        QSet<QString> withPrefix;
+        for (auto it = m_postings.lowerBound(prefix); it != m_postings.cend() && it.key().startsWith(prefix); ++it)
+            withPrefix.unite(it.value());
+        // Every word of the query has to match, each against any word of the
+        // conversation.
+        if (i == 0)
+            matched = std::move(withPrefix);
+        else
+            matched.intersect(withPrefix);
+        if (matched.isEmpty())
+            break;
+    }
+    return matched;
+}
+
+QStringList ConversationSearchIndex::words(const QString& text)
+{
+    QStringList found;
+    const QString folded = text.toCaseFolded();
+    qsizetype start = -1;
+    for (qsizetype i = 0; i <= folded.size(); ++i) {
+        const bool inWord = i < folded.size() && folded.at(i).isLetterOrNumber();
+        if (inWord && start < 0) {
+            start = i;
+        } else if (!inWord && start >= 0) {
+            found.append(folded.mid(start, i - start));
+            start = -1;
+        }
+    }
+    return found;
+}
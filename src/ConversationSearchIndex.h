@@ -0,0 +1,39 @@
+#ifndef CONVERSATION_SEARCH_INDEX_H
+#define CONVERSATION_SEARCH_INDEX_H
+
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+// The words of each conversation's searchable text, kept sorted so every word
+// starting with a prefix sits in one contiguous range. A query is answered by
+// walking that range for each of its words, so it costs what it matches rather
+// than what the list holds. Updated a conversation at a time as its text
+// changes; comparisons are case-folded.
+//
+// Not thread-safe.
+class ConversationSearchIndex
+{
+public:
+    // Indexes `fields` under `id`, replacing whatever was indexed for it.
+    void set(const QString& id, const QStringList& fields);
+    void remove(const QString& id);
+    void clear();
+
+    // The conversations with a word starting with each word of `query`, in no
+    // particular order. Empty for a query without a word in it.
+    QSet<QString> match(const QString& query) const;
+
+    // The case-folded words of `text`: runs of letters and digits.
+    static QStringList words(const QString& text);
+
+private:
+    // Conversation ids by word.
+    QMap<QString, QSet<QString>> m_postings;
+    // The words each conversation is filed under, to take it out again.
+    QHash<QString, QSet<QString>> m_wordsOf;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#include "ConversationSnapshot.h"
+
+#include "RecordFile.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+namespace {
+
+// "CVL1": the conversation list, one row per record. A new field in a record
+// means a new kFormat, so an older run's snapshot is skipped, not misread.
+constexpr quint32 kMagic = 0x43564c31;
+constexpr quint16 kFormat = 1;
+
+} // namespace
+
+namespace ConversationSnapshot {
+
+bool save(const QString& path, const QVector<ConversationItem>& conversations)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    QDataStream out(&file);
+    RecordFile::writeHeader(out, kMagic, kFormat, quint32(conversations.size()));
+    for (const ConversationItem& item : conversations) {
+        out << item.conversationId << item.displayName << item.description << item.lastActivity
+            << item.isGroup << item.preview;
+    }
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+bool load(const QString& path, QVector<ConversationItem>* conversations)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 entries = 0;
+    if (!RecordFile::readHeader(in, kMagic, kFormat, &entries))
+        return false;
+
+    QVector<ConversationItem> read;
+    for (quint32 i = 0; i < entries && in.status() == QDataStream::Ok; ++i) {
+        ConversationItem item;
+        in >> item.conversationId >> item.displayName >> item.description >> item.lastActivity
+            >> item.isGroup >> item.preview;
+        read.append(std::move(item));
+    }
+    if (in.status() != QDataStream::Ok)
+        return false;
+    *conversations = std::move(read);
+    return true;
+}
+
+} // namespace ConversationSnapshot
@@ -0,0 +1,26 @@
+#ifndef CONVERSATION_SNAPSHOT_H
+#define CONVERSATION_SNAPSHOT_H
+
+#include "ConversationListModel.h"
+
+#include <QString>
+#include <QVector>
+
+// The conversation list as it last stood, kept on disk so the next start can
+// list it before the module is up, which takes seconds. Only what a row is
+// built from is kept; its derived fields are redone as it goes back in, and
+// unread counts are UnreadStore's. The file is replaced whole and atomically.
+namespace ConversationSnapshot {
+
+inline constexpr const char* kFileName = "chat_ui_conversations.dat";
+
+// Writes `conversations`, in list order, to `path`. False when that failed.
+bool save(const QString& path, const QVector<ConversationItem>& conversations);
+
+// Reads what save() wrote to `path` into `conversations`. False when there is
+// no file or it is unreadable, leaving `conversations` as it was.
+bool load(const QString& path, QVector<ConversationItem>* conversations);
+
+} // namespace ConversationSnapshot
+
+#endif
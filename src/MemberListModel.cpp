@@ -1,6 +1,9 @@
 #include "MemberListModel.h"
 #include "Identity.h"
 
+#include <QHash>
+#include <utility>
+
 MemberListModel::MemberListModel(QObject* parent)
     : QAbstractListModel(parent)
 {
@@ -47,9 +50,98 @@ QHash<int, QByteArray> MemberListModel::roleNames() const
 
 void MemberListModel::setMembers(const QVector<MemberItem>& members)
 {
-    beginResetModel();
-    m_items = members;
-    endResetModel();
+    if (m_items.isEmpty()) {
+        if (members.isEmpty()) return;
+        beginResetModel();
+        m_items = members;
+        for (const MemberItem& item : std::as_const(m_items))
+            count(item, 1);
+        reindex();
+        endResetModel();
+        return;
+    }
+
+    // The edit script, on addresses: walk both lists in roster order, keeping a
+    // member both hold where they line up, removing a row the roster lacks and
+    // inserting a member the rows lack. A member both hold but out of line is
+    // removed where it was and inserted where it now is. Counted rather than
+    // looked up, as several members with no confirmed account share the empty
+    // address.
+    enum class Edit { Keep, Remove, Insert };
+    QHash<QString, int> rowsLeft;
+    for (const MemberItem& item : std::as_const(m_items))
+        ++rowsLeft[item.address];
+    QHash<QString, int> freshLeft;
+    for (const MemberItem& item : members)
+        ++freshLeft[item.address];
+
+    QVector<Edit> script;
+    for (int i = 0, j = 0; i < m_items.size() || j < members.size();) {
+        const bool haveRow = i < m_items.size();
+        const bool haveFresh = j < members.size();
+        if (haveRow && freshLeft.value(m_items.at(i).address) == 0) {
+            script.append(Edit::Remove);
+            --rowsLeft[m_items.at(i++).address];
+        } else if (haveFresh && rowsLeft.value(members.at(j).address) == 0) {
+            script.append(Edit::Insert);
+            --freshLeft[members.at(j++).address];
+        } else if (haveRow && haveFresh && m_items.at(i).address == members.at(j).address) {
+            script.append(Edit::Keep);
+            --rowsLeft[m_items.at(i++).address];
+            --freshLeft[members.at(j++).address];
+        } else {
+            script.append(Edit::Remove);
+            --rowsLeft[m_items.at(i++).address];
+        }
+    }
+
+    // Applied a run at a time, so each contiguous stretch of inserts or
+    // removals reaches the view as one change.
+    int row = 0;
+    int next = 0;
+    for (int k = 0; k < script.size();) {
+        const Edit edit = script.at(k);
+        int run = 1;
+        while (k + run < script.size() && script.at(k + run) == edit)
+            ++run;
+        if (edit == Edit::Keep) {
+            for (int r = row; r < row + run; ++r, ++next) {
+                MemberItem& item = m_items[r];
+                const MemberItem& fresh = members.at(next);
+                QList<int> roles;
+                if (item.pending != fresh.pending)
+                    roles.append(PendingRole);
+                if (item.isSelf != fresh.isSelf)
+                    roles.append(IsSelfRole);
+                if (roles.isEmpty()) continue;
+                count(item, -1);
+                item = fresh;
+                count(item, 1);
+                emit dataChanged(index(r), index(r), roles);
+            }
+            row += run;
+        } else if (edit == Edit::Remove) {
+            beginRemoveRows(QModelIndex(), row, row + run - 1);
+            for (int r = row; r < row + run; ++r)
+                count(m_items.at(r), -1);
+            m_items.remove(row, run);
+            endRemoveRows();
+        } else {
+            beginInsertRows(QModelIndex(), row, row + run - 1);
+            m_items.insert(row, run, MemberItem());
+            for (int r = row; r < row + run; ++r, ++next) {
+                m_items[r] = members.at(next);
+                count(m_items.at(r), 1);
+            }
+            endInsertRows();
+            row += run;
+        }
+        k += run;
+    }
+    // Once, for the whole edit: rebuilding is a pass over the roster, as the
+    // edit script was, where keeping it per run could be one per row.
+    if (!script.isEmpty())
+        reindex();
 }
 
 void MemberListModel::clear()
@@ -57,14 +149,51 @@ void MemberListModel::clear()
     if (m_items.isEmpty()) return;
     beginResetModel();
     m_items.clear();
+    m_rows.clear();
+    m_committedAddresses.clear();
+    m_committed = 0;
+    m_pending = 0;
     endResetModel();
 }
 
 bool MemberListModel::contains(const QString& address) const
 {
-    for (const auto& item : m_items) {
-        if (!item.pending && item.address == address)
-            return true;
+    return m_committedAddresses.contains(address);
+}
+
+int MemberListModel::indexOfAddress(const QString& address) const
+{
+    return m_rows.value(address, -1);
+}
+
+int MemberListModel::committedCount() const
+{
+    return m_committed;
+}
+
+int MemberListModel::pendingCount() const
+{
+    return m_pending;
+}
+
+void MemberListModel::count(const MemberItem& item, int sign)
+{
+    if (item.pending)
+        m_pending += sign;
+    else
+        m_committed += sign;
+}
+
+void MemberListModel::reindex()
+{
+    m_rows.clear();
+    m_committedAddresses.clear();
+    m_rows.reserve(m_items.size());
+    // Backwards, so an address held by several rows names the first.
+    for (int row = static_cast<int>(m_items.size()) - 1; row >= 0; --row) {
+        const MemberItem& item = m_items.at(row);
+        m_rows.insert(item.address, row);
+        if (!item.pending)
+            m_committedAddresses.insert(item.address);
     }
-    return false;
 }
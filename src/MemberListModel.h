@@ -2,6 +2,8 @@
 #define MEMBER_LIST_MODEL_H
 
 #include <QAbstractListModel>
+#include <QHash>
+#include <QSet>
 #include <QString>
 #include <QVector>
 
@@ -15,9 +17,11 @@ struct MemberItem {
     bool pending = false;
 };
 
-// A group's roster, replaced wholesale on each refresh. `label` is the short
-// form of `address` (or "unknown_account" when the address is empty), computed
-// here so QML renders a consistent identity string.
+// A group's roster, brought in line with each refresh by the fewest row
+// inserts, removals and role changes, so an invite being committed touches one
+// row rather than every delegate. `label` is the short form of `address` (or
+// "unknown_account" when the address is empty), computed here so QML renders a
+// consistent identity string.
 class MemberListModel : public QAbstractListModel
 {
     Q_OBJECT
@@ -40,14 +44,39 @@ public:
     QVariant data(const QModelIndex& index, int role) const override;
     QHash<int, QByteArray> roleNames() const override;
 
+    // Matches rows to `members` by address, in the roster's order: a member
+    // both hold keeps its row and is told only the roles that changed, one the
+    // roster lacks is removed and one it adds is inserted, a run at a time.
     void setMembers(const QVector<MemberItem>& members);
     void clear();
     // True when `address` is a committed member. A pending invite does not
     // count: it cannot take part in the conversation until the group commits it.
     bool contains(const QString& address) const;
+    // The row of the member with `address`, committed or not; -1 when there is
+    // none. Like the conversation model's lookups, reachable from C++ and an
+    // in-process view, not through the replica.
+    Q_INVOKABLE int indexOfAddress(const QString& address) const;
+
+    // Members committed into the group, and invites awaiting its commit; kept
+    // as rows change rather than counted on each refresh.
+    int committedCount() const;
+    int pendingCount() const;
 
 private:
+    // Adds a row's member to the counts, or with `sign` -1 takes it out.
+    void count(const MemberItem& item, int sign);
+    // Rebuilds m_rows and m_committedAddresses after the rows changed.
+    void reindex();
+
     QVector<MemberItem> m_items;
+    // Row by address, and the committed members' addresses. An incoming
+    // message in a group asks whether its sender is a member, so a roster of
+    // thousands is looked up rather than scanned for each; a refresh, which
+    // walks the roster anyway, rebuilds them.
+    QHash<QString, int> m_rows;
+    QSet<QString> m_committedAddresses;
+    int m_committed = 0;
+    int m_pending = 0;
 };
 
 #endif
@@ -4,47 +4,74 @@
 #include "TimeFormat.h"
 
 #include <QDate>
+#include <QDateTime>
 #include <QLocale>
+#include <QTimer>
 #include <algorithm>
+#include <iterator>
 #include <utility>
 
+namespace {
+
+// Moves the newest `count` messages (the back of an oldest-first list) out of
+// `items` into a list of their own, leaving the older ones where they were.
+QVector<MessageItem> takeNewest(QVector<MessageItem>& items, qsizetype count)
+{
+    const qsizetype start = qMax<qsizetype>(0, items.size() - count);
+    QVector<MessageItem> newest(std::make_move_iterator(items.begin() + start),
+                                std::make_move_iterator(items.end()));
+    items.resize(start);
+    return newest;
+}
+
+quint64 fingerprint(bool isMe, qint64 timestampMs, const QString& content, const QString& sender)
+{
+    return qHashMulti(0, int(isMe), timestampMs, content, sender);
+}
+
+quint64 fingerprintOf(const MessageItem& item)
+{
+    return fingerprint(item.isMe, item.timestampMs, item.content, item.sender);
+}
+
+// Past midnight by this much before the day labels are redone, so a timer that
+// fires a touch early does not label the old day "Today" again.
+constexpr int kRolloverSlackMs = 1000;
+
+} // namespace
+
 MessageListModel::MessageListModel(QObject* parent)
     : QAbstractListModel(parent)
+    , m_dayRollover(new QTimer(this))
 {
+    m_dayRollover->setSingleShot(true);
+    connect(m_dayRollover, &QTimer::timeout, this, [this] { rollOverDay(); });
+    scheduleDayRollover();
 }
 
 int MessageListModel::rowCount(const QModelIndex& parent) const
 {
     if (parent.isValid()) return 0;
-    return m_items.size();
+    return static_cast<int>(m_items.size());
 }
 
 QVariant MessageListModel::data(const QModelIndex& index, int role) const
 {
-    if (!index.isValid() || index.row() >= m_items.size())
+    if (!index.isValid() || index.row() >= rowCount())
         return {};
 
-    const auto& item = m_items.at(index.row());
-    // The older neighbour renders directly above this row (newest-first model,
-    // BottomToTop list), so index+1 is the chronologically previous message.
-    const int older = index.row() + 1;
+    const Row& row = m_items.at(index.row());
     switch (role) {
-    case SenderRole:    return item.sender;
-    case ContentRole:   return item.content;
-    case TimestampRole: return item.timestamp;
-    case IsMeRole:      return item.isMe;
-    case SameSenderAsPreviousRole: {
-        if (older >= m_items.size()) return false;
-        const auto& prev = m_items.at(older);
-        return item.sender == prev.sender && item.isMe == prev.isMe
-            && item.timestamp.date() == prev.timestamp.date();
-    }
-    case ShowDaySeparatorRole:
-        return older >= m_items.size() || item.timestamp.date() != m_items.at(older).timestamp.date();
-    case DayLabelRole:  return dayLabel(item.timestamp);
-    case TimeDisplayRole: return TimeFormat::shortTime(item.timestamp);
-    case AvatarInitialsRole: return Identity::initials(item.sender);
-    case AvatarRampRole:     return Identity::avatarRamp(item.sender);
+    case SenderRole:    return m_senders.at(row.sender).label;
+    case ContentRole:   return row.content;
+    case TimestampRole: return QDateTime::fromMSecsSinceEpoch(row.timestampMs);
+    case IsMeRole:      return bool(row.isMe);
+    case SameSenderAsPreviousRole: return bool(row.sameSenderAsPrevious);
+    case ShowDaySeparatorRole:     return bool(row.showDaySeparator);
+    case DayLabelRole:  return dayLabel(row.day);
+    case TimeDisplayRole: return m_timeLabels.value(row.minute);
+    case AvatarInitialsRole: return m_senders.at(row.sender).initials;
+    case AvatarRampRole:     return m_senders.at(row.sender).ramp;
     default:            return {};
     }
 }
@@ -65,23 +92,117 @@ QHash<int, QByteArray> MessageListModel::roleNames() const
     };
 }
 
+bool MessageListModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && !m_olderHistory.isEmpty();
+}
+
+void MessageListModel::fetchMore(const QModelIndex& parent)
+{
+    if (!canFetchMore(parent)) return;
+    // The next page older is the newest of what is held back, and it goes
+    // through the same older-history append as any other batch.
+    addMessages(takeNewest(m_olderHistory, kPageSize));
+    // Shrinking keeps the whole thread's allocation; once it is all in the
+    // rows, nothing is held back to need it.
+    if (m_olderHistory.isEmpty())
+        m_olderHistory.squeeze();
+}
+
 void MessageListModel::addMessage(const QString& sender, const QString& content,
-                                  const QDateTime& timestamp, bool isMe)
-{
-    // Drop an exact duplicate of the newest message. A reconnect resync reloads
-    // the active thread via get_messages while live events still push, so a
-    // message persisted just before the reload and delivered just after would
-    // otherwise appear twice; distinct messages never share content + timestamp
-    // + sender. The model is newest-first, so the newest row is the front.
-    if (!m_items.isEmpty()) {
-        const MessageItem& newest = m_items.first();
-        if (newest.isMe == isMe && newest.timestamp == timestamp && newest.content == content)
-            return;
+                                  qint64 timestampMs, bool isMe)
+{
+    addNewMessages({ { sender, content, timestampMs, isMe } });
+}
+
+void MessageListModel::addNewMessages(QVector<MessageItem> items)
+{
+    // Drop a message the model already holds. A reconnect resync reloads the
+    // active thread via get_messages while live events still push, so a message
+    // persisted just before the reload and delivered just after would otherwise
+    // appear twice, and the overlap is not always the newest row alone; distinct
+    // messages never share content + timestamp + sender. The fingerprint only
+    // narrows it down: one that matches is dropped only once the message is
+    // found, here or earlier in the batch, so a collision costs a lookup rather
+    // than a message.
+    QVector<MessageItem> fresh;
+    fresh.reserve(items.size());
+    for (MessageItem& item : items) {
+        const quint64 fingerprint = fingerprintOf(item);
+        if (m_fingerprints.contains(fingerprint) && (fresh.contains(item) || holds(item)))
+            continue;
+        m_fingerprints.insert(fingerprint);
+        fresh.append(std::move(item));
+    }
+    if (fresh.isEmpty()) return;
+
+    // Arrival order is not send order: a message held up on the delivery
+    // network, or replayed after a reconnect, comes in behind newer ones. The
+    // batch goes into timestamp order (stably, so messages sharing a timestamp
+    // keep their arrival order) and splits where it turns newer than every row.
+    std::stable_sort(fresh.begin(), fresh.end(), [](const MessageItem& left, const MessageItem& right) {
+        return left.timestampMs < right.timestampMs;
+    });
+    qsizetype late = 0;
+    if (!m_items.empty()) {
+        const qint64 newest = m_items.front().timestampMs;
+        late = std::partition_point(fresh.cbegin(), fresh.cend(), [newest](const MessageItem& item) {
+            return item.timestampMs < newest;
+        }) - fresh.cbegin();
+    }
+    for (qsizetype i = 0; i < late; ++i)
+        insertByTimestamp(std::move(fresh[i]));
+
+    // The rest are newer than every row, the usual case, and go in at the
+    // front as one insert.
+    std::deque<Row> rows;
+    for (qsizetype i = late; i < fresh.size(); ++i)
+        rows.push_front(makeRow(std::move(fresh[i])));
+    const int n = static_cast<int>(rows.size());
+    if (n == 0) return;
+
+    // The rows already in keep their older neighbours, so only the new ones are
+    // grouped, the oldest of them against the row that was newest.
+    for (int row = n - 1; row >= 0; --row) {
+        const Row* older = row + 1 < n ? &rows[row + 1]
+                         : m_items.empty() ? nullptr : &m_items.front();
+        group(rows[row], older);
+    }
+    beginInsertRows(QModelIndex(), 0, n - 1);
+    m_items.insert(m_items.begin(), std::make_move_iterator(rows.begin()),
+                   std::make_move_iterator(rows.end()));
+    endInsertRows();
+}
+
+void MessageListModel::insertByTimestamp(MessageItem item)
+{
+    // The rows are newest-first, so in descending timestamp order: the message
+    // goes above the first row no newer than it.
+    const qint64 at = item.timestampMs;
+    const auto below = std::partition_point(m_items.cbegin(), m_items.cend(), [at](const Row& row) {
+        return row.timestampMs > at;
+    });
+    const int row = static_cast<int>(below - m_items.cbegin());
+    if (row == rowCount() && !m_olderHistory.isEmpty()) {
+        // Older than every row, with history still held back beneath them: it
+        // belongs in that history, and shows when its page is fetched.
+        const auto slot = std::upper_bound(m_olderHistory.begin(), m_olderHistory.end(), at,
+                                           [](qint64 when, const MessageItem& held) {
+            return when < held.timestampMs;
+        });
+        m_olderHistory.insert(slot, std::move(item));
+        return;
     }
 
-    beginInsertRows(QModelIndex(), 0, 0);
-    m_items.prepend({ sender, content, timestamp, isMe });
+    Row inserted = makeRow(std::move(item));
+    group(inserted, row < rowCount() ? &m_items[row] : nullptr);
+    beginInsertRows(QModelIndex(), row, row);
+    m_items.insert(m_items.begin() + row, std::move(inserted));
     endInsertRows();
+    // Of the rows around it, only the newer one is grouped against what lies
+    // beneath it.
+    if (row > 0)
+        regroup(row - 1);
 }
 
 void MessageListModel::addMessages(QVector<MessageItem> items)
@@ -92,17 +213,20 @@ void MessageListModel::addMessages(QVector<MessageItem> items)
     // get_messages returns the thread oldest-first; the model is newest-first
     // (row 0 is the newest message, which the BottomToTop list pins to the
     // visual bottom), so reverse the batch before appending it as older history.
-    std::reverse(items.begin(), items.end());
-    const int firstRow = m_items.size();
+    const int firstRow = rowCount();
     beginInsertRows(QModelIndex(), firstRow, firstRow + n - 1);
-    m_items += std::move(items);
+    for (auto it = items.rbegin(); it != items.rend(); ++it) {
+        m_fingerprints.insert(fingerprintOf(*it));
+        m_items.push_back(makeRow(std::move(*it)));
+    }
+    for (int row = rowCount() - 1; row >= firstRow; --row)
+        group(m_items[row], row + 1 < rowCount() ? &m_items[row + 1] : nullptr);
     endInsertRows();
 
     // The row that was oldest now has an older neighbour beneath it, so its
     // day-separator and grouping flags may have flipped.
     if (firstRow > 0)
-        emit dataChanged(index(firstRow - 1), index(firstRow - 1),
-                         { SameSenderAsPreviousRole, ShowDaySeparatorRole });
+        regroup(firstRow - 1);
 }
 
 void MessageListModel::setMessages(QVector<MessageItem> items)
@@ -111,31 +235,261 @@ void MessageListModel::setMessages(QVector<MessageItem> items)
     // thread oldest-first and the model is newest-first, so reverse as
     // addMessages does. Doing this as one reset (rather than clear() then
     // addMessages()) means the list never passes through an empty state, so
-    // switching conversations does not flash the view empty.
-    std::reverse(items.begin(), items.end());
+    // switching conversations does not flash the view empty. Only the newest
+    // page goes into the rows; fetchMore brings in the rest as it is scrolled to.
+    QVector<MessageItem> page = takeNewest(items, kPageSize);
+    m_senders.clear();
+    m_senderIndex.clear();
+    QSet<quint64> fingerprints;
+    fingerprints.reserve(items.size() + page.size());
+    for (const MessageItem& item : std::as_const(items))
+        fingerprints.insert(fingerprintOf(item));
+    for (const MessageItem& item : std::as_const(page))
+        fingerprints.insert(fingerprintOf(item));
+    std::deque<Row> rows;
+    for (auto it = page.rbegin(); it != page.rend(); ++it)
+        rows.push_back(makeRow(std::move(*it)));
+    for (auto row = rows.rbegin(); row != rows.rend(); ++row)
+        group(*row, row == rows.rbegin() ? nullptr : &*std::prev(row));
     beginResetModel();
-    m_items = std::move(items);
+    m_items.swap(rows);
+    m_olderHistory = std::move(items);
+    m_fingerprints.swap(fingerprints);
     endResetModel();
 }
 
+void MessageListModel::reconcile(QVector<MessageItem> items)
+{
+    if (m_items.empty()) {
+        setMessages(std::move(items));
+        return;
+    }
+
+    // Newest-first from here on, as the rows are.
+    std::reverse(items.begin(), items.end());
+    const int fresh = static_cast<int>(items.size());
+    QVector<quint64> freshPrints;
+    freshPrints.reserve(fresh);
+    for (const MessageItem& item : std::as_const(items))
+        freshPrints.append(fingerprintOf(item));
+
+    // The rows go on reaching down to the message that is oldest in them now;
+    // if the module no longer has it, to as many messages as there were rows.
+    const quint64 oldestShown = rowFingerprint(m_items.back());
+    int shown = static_cast<int>(freshPrints.indexOf(oldestShown)) + 1;
+    if (shown == 0)
+        shown = qMin(fresh, qMax(rowCount(), static_cast<int>(kPageSize)));
+
+    // The edit script, on fingerprints: walk both lists newest-first, keeping a
+    // message both hold where they line up, removing a row the fresh read lacks
+    // and inserting a message the rows lack. A message both hold but out of
+    // line is removed where it was and inserted where it now belongs.
+    enum class Edit { Keep, Remove, Insert };
+    QVector<quint64> rowPrints;
+    rowPrints.reserve(rowCount());
+    QHash<quint64, int> rowsLeft;
+    for (const Row& row : m_items) {
+        rowPrints.append(rowFingerprint(row));
+        ++rowsLeft[rowPrints.last()];
+    }
+    QHash<quint64, int> freshLeft;
+    for (int j = 0; j < shown; ++j)
+        ++freshLeft[freshPrints.at(j)];
+
+    QVector<Edit> script;
+    for (int i = 0, j = 0; i < rowPrints.size() || j < shown;) {
+        const bool haveRow = i < rowPrints.size();
+        const bool haveFresh = j < shown;
+        if (haveRow && freshLeft.value(rowPrints.at(i)) == 0) {
+            script.append(Edit::Remove);
+            --rowsLeft[rowPrints.at(i++)];
+        } else if (haveFresh && rowsLeft.value(freshPrints.at(j)) == 0) {
+            script.append(Edit::Insert);
+            --freshLeft[freshPrints.at(j++)];
+        } else if (haveRow && haveFresh && rowPrints.at(i) == freshPrints.at(j)
+                   && isMessage(m_items.at(i), items.at(j))) {
+            script.append(Edit::Keep);
+            --rowsLeft[rowPrints.at(i++)];
+            --freshLeft[freshPrints.at(j++)];
+        } else {
+            script.append(Edit::Remove);
+            --rowsLeft[rowPrints.at(i++)];
+        }
+    }
+
+    // Applied a run at a time, so each contiguous stretch of inserts or
+    // removals reaches the view as one change. The row above a run gets a new
+    // older neighbour, so it is regrouped once the edits are in; the runs go
+    // top down, so the later ones do not shift it.
+    QVector<int> above;
+    int row = 0;
+    int next = 0;
+    for (int k = 0; k < script.size();) {
+        const Edit edit = script.at(k);
+        int run = 1;
+        while (k + run < script.size() && script.at(k + run) == edit)
+            ++run;
+        if (edit != Edit::Keep && row > 0 && (above.isEmpty() || above.last() != row - 1))
+            above.append(row - 1);
+        if (edit == Edit::Keep) {
+            row += run;
+            next += run;
+        } else if (edit == Edit::Remove) {
+            beginRemoveRows(QModelIndex(), row, row + run - 1);
+            m_items.erase(m_items.begin() + row, m_items.begin() + row + run);
+            endRemoveRows();
+        } else {
+            std::deque<Row> inserted;
+            for (int j = next; j < next + run; ++j)
+                inserted.push_back(makeRow(std::move(items[j])));
+            beginInsertRows(QModelIndex(), row, row + run - 1);
+            m_items.insert(m_items.begin() + row, std::make_move_iterator(inserted.begin()),
+                           std::make_move_iterator(inserted.end()));
+            for (int r = row + run - 1; r >= row; --r)
+                group(m_items[r], r + 1 < rowCount() ? &m_items[r + 1] : nullptr);
+            endInsertRows();
+            row += run;
+            next += run;
+        }
+        k += run;
+    }
+
+    QVector<MessageItem> older(std::make_move_iterator(items.rbegin()),
+                               std::make_move_iterator(items.rend() - shown));
+    m_olderHistory = std::move(older);
+    m_fingerprints = QSet<quint64>(freshPrints.cbegin(), freshPrints.cend());
+    for (int stale : std::as_const(above))
+        regroup(stale);
+}
+
 void MessageListModel::clear()
 {
-    if (m_items.isEmpty()) return;
+    m_olderHistory.clear();
+    m_fingerprints.clear();
+    if (m_items.empty()) {
+        m_senders.clear();
+        m_senderIndex.clear();
+        return;
+    }
     beginResetModel();
     m_items.clear();
+    m_senders.clear();
+    m_senderIndex.clear();
     endResetModel();
 }
 
-QString MessageListModel::dayLabel(const QDateTime& timestamp) const
+MessageListModel::Row MessageListModel::makeRow(MessageItem item)
 {
-    if (!timestamp.isValid())
-        return {};
+    // The one place a row's timestamp is taken apart in local time; from here
+    // on only the day and minute it fell on are needed.
+    const QDateTime when = QDateTime::fromMSecsSinceEpoch(item.timestampMs);
+    const QTime time = when.time();
+    Row row;
+    row.content = std::move(item.content);
+    row.timestampMs = item.timestampMs;
+    row.day = static_cast<qint32>(when.date().toJulianDay());
+    row.sender = internSender(item.sender);
+    row.minute = time.hour() * 60 + time.minute();
+    row.isMe = item.isMe;
+    if (!m_timeLabels.contains(row.minute))
+        m_timeLabels.insert(row.minute, TimeFormat::shortTime(when));
+    return row;
+}
+
+quint32 MessageListModel::internSender(const QString& label)
+{
+    const auto found = m_senderIndex.constFind(label);
+    if (found != m_senderIndex.cend())
+        return *found;
+    const quint32 index = static_cast<quint32>(m_senders.size());
+    m_senders.append({ label, Identity::initials(label), Identity::avatarRamp(label) });
+    m_senderIndex.insert(label, index);
+    return index;
+}
 
+quint64 MessageListModel::rowFingerprint(const Row& row) const
+{
+    return fingerprint(row.isMe, row.timestampMs, row.content, m_senders.at(row.sender).label);
+}
+
+bool MessageListModel::isMessage(const Row& row, const MessageItem& item) const
+{
+    return row.timestampMs == item.timestampMs && bool(row.isMe) == item.isMe && row.content == item.content
+        && m_senders.at(row.sender).label == item.sender;
+}
+
+bool MessageListModel::holds(const MessageItem& item) const
+{
+    // The rows newest-first, the history oldest-first: either way sorted by
+    // timestamp, so only the few sharing the item's are compared.
+    const qint64 at = item.timestampMs;
+    const auto rowsFrom = std::partition_point(m_items.cbegin(), m_items.cend(), [at](const Row& row) {
+        return row.timestampMs > at;
+    });
+    for (auto row = rowsFrom; row != m_items.cend() && row->timestampMs == at; ++row) {
+        if (isMessage(*row, item))
+            return true;
+    }
+    const auto heldFrom = std::partition_point(m_olderHistory.cbegin(), m_olderHistory.cend(),
+                                               [at](const MessageItem& held) { return held.timestampMs < at; });
+    for (auto held = heldFrom; held != m_olderHistory.cend() && held->timestampMs == at; ++held) {
+        if (*held == item)
+            return true;
+    }
+    return false;
+}
+
+bool MessageListModel::group(Row& row, const Row* older)
+{
+    const bool sameDay = older && older->day == row.day;
+    const bool sameSender = sameDay && older->sender == row.sender
+        && older->isMe == row.isMe;
+    if (row.sameSenderAsPrevious == sameSender && row.showDaySeparator == !sameDay)
+        return false;
+    row.sameSenderAsPrevious = sameSender;
+    row.showDaySeparator = !sameDay;
+    return true;
+}
+
+void MessageListModel::regroup(int row)
+{
+    const Row* older = row + 1 < rowCount() ? &m_items[row + 1] : nullptr;
+    if (group(m_items[row], older))
+        emit dataChanged(index(row), index(row), { SameSenderAsPreviousRole, ShowDaySeparatorRole });
+}
+
+QString MessageListModel::dayLabel(qint64 day) const
+{
+    const auto cached = m_dayLabels.constFind(day);
+    if (cached != m_dayLabels.cend())
+        return *cached;
+
+    const QDate date = QDate::fromJulianDay(day);
     const QDate today = QDate::currentDate();
-    const QDate date = timestamp.date();
-    if (date == today)
-        return tr("Today");
-    if (date == today.addDays(-1))
-        return tr("Yesterday");
-    return QLocale::system().toString(date, QLocale::ShortFormat);
+    QString label;
+    if (!date.isValid())
+        label = QString();
+    else if (date == today)
+        label = tr("Today");
+    else if (date == today.addDays(-1))
+        label = tr("Yesterday");
+    else
+        label = QLocale::system().toString(date, QLocale::ShortFormat);
+    m_dayLabels.insert(day, label);
+    return label;
+}
+
+void MessageListModel::scheduleDayRollover()
+{
+    const QDateTime now = QDateTime::currentDateTime();
+    const qint64 untilMidnight = now.msecsTo(now.date().addDays(1).startOfDay());
+    m_dayRollover->start(static_cast<int>(untilMidnight) + kRolloverSlackMs);
+}
+
+void MessageListModel::rollOverDay()
+{
+    m_dayLabels.clear();
+    if (!m_items.empty())
+        emit dataChanged(index(0), index(rowCount() - 1), { DayLabelRole });
+    scheduleDayRollover();
 }
@@ -2,17 +2,29 @@
 #define MESSAGE_LIST_MODEL_H
 
 #include <QAbstractListModel>
-#include <QDateTime>
+#include <QHash>
+#include <QSet>
 #include <QString>
 #include <QVector>
+#include <deque>
 
+class QTimer;
+
+// A message as the module reports it. The timestamp stays in the module's own
+// epoch milliseconds: a QDateTime is built only when TimestampRole is read.
 struct MessageItem {
     QString sender;
     QString content;
-    QDateTime timestamp;
+    qint64 timestampMs;
     bool isMe;
 };
 
+inline bool operator==(const MessageItem& left, const MessageItem& right)
+{
+    return left.isMe == right.isMe && left.timestampMs == right.timestampMs
+        && left.content == right.content && left.sender == right.sender;
+}
+
 class MessageListModel : public QAbstractListModel
 {
     Q_OBJECT
@@ -38,23 +50,123 @@ public:
         AvatarRampRole
     };
 
+    // Messages a thread is loaded with, and fetched by, at a time. A long thread
+    // opens on its newest page; the rest waits here until the view scrolls up to
+    // it, so neither the view nor the replica takes it on before it is read.
+    static constexpr int kPageSize = 100;
+
     explicit MessageListModel(QObject* parent = nullptr);
 
     int rowCount(const QModelIndex& parent = QModelIndex()) const override;
     QVariant data(const QModelIndex& index, int role) const override;
     QHash<int, QByteArray> roleNames() const override;
 
+    // Whether older history is held back, and the next page of it appended as
+    // older rows.
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
     void addMessage(const QString& sender, const QString& content,
-                    const QDateTime& timestamp, bool isMe);
+                    qint64 timestampMs, bool isMe);
+    // Live messages, in arrival order. Those newer than every row, the usual
+    // case, go in at the front as one contiguous insert; one that arrived late
+    // is placed by its timestamp, among the rows or in the held-back history.
+    // A message the model already holds is dropped.
+    void addNewMessages(QVector<MessageItem> items);
     void addMessages(QVector<MessageItem> items);
+    // Replaces the thread, oldest-first as get_messages returns it. Only the
+    // newest kPageSize messages become rows; the rest are held for fetchMore.
     void setMessages(QVector<MessageItem> items);
+    // Brings the thread in line with a fresh read of it, oldest-first as
+    // get_messages returns it, by the fewest row inserts and removals rather
+    // than a reset: the delegates, the scroll position and the replica's rows
+    // for every message that did not change are left alone. The rows keep
+    // reaching as far back as they did; anything older is held back as before.
+    void reconcile(QVector<MessageItem> items);
     void clear();
 
 private:
-    // "Today" / "Yesterday" / short date for a day-separator heading.
-    QString dayLabel(const QDateTime& timestamp) const;
+    // A message and the roles derived from it, worked out once as the row goes
+    // in rather than on every read: a delegate recycled while scrolling reads
+    // them all again. The grouping flags also depend on the older neighbour, so
+    // they are refreshed only where that neighbour changes.
+    //
+    // Kept to 40 bytes plus the content: a thread may run to a hundred thousand
+    // rows, and everything a row repeats from its neighbours (the sender, its
+    // avatar, the clock time) lives once in a pool it indexes instead.
+    struct Row {
+        QString content;
+        qint64 timestampMs = 0;
+        // The local calendar day of the timestamp, as a Julian day number.
+        qint32 day = 0;
+        // Index into m_senders.
+        quint32 sender : 18;
+        // Local minute of the day, the key into m_timeLabels.
+        quint32 minute : 11;
+        quint32 isMe : 1;
+        quint32 sameSenderAsPrevious : 1;
+        quint32 showDaySeparator : 1;
+
+        Row() : sender(0), minute(0), isMe(0), sameSenderAsPrevious(0), showDaySeparator(1) {}
+    };
+
+    // A sender as the rows share it: the label and the avatar identity derived
+    // from it, once per distinct sender rather than once per row.
+    struct Sender {
+        QString label;
+        QString initials;
+        int ramp = 0;
+    };
+
+    Row makeRow(MessageItem item);
+    // Places one message older than the newest row where its timestamp puts
+    // it, found by binary search over the rows.
+    void insertByTimestamp(MessageItem item);
+    // The pool index for `label`, adding it on first sight.
+    quint32 internSender(const QString& label);
+    // The fingerprint the row's message had as a MessageItem.
+    quint64 rowFingerprint(const Row& row) const;
+    // Whether the row is `item`'s message, field by field.
+    bool isMessage(const Row& row, const MessageItem& item) const;
+    // Whether the rows or the held-back history hold `item`, found by its
+    // timestamp. What a fingerprint match is checked with before a message is
+    // dropped as a duplicate, as two messages may share a fingerprint.
+    bool holds(const MessageItem& item) const;
+    // Sets `row`'s grouping flags against `older`, the row beneath it or null
+    // for the oldest loaded. True when either flag changed.
+    static bool group(Row& row, const Row* older);
+    // Regroups one row against its current older neighbour and tells the view
+    // when that changed anything.
+    void regroup(int row);
+
+    // "Today" / "Yesterday" / short date for a day-separator heading, cached per
+    // day until the date rolls over.
+    QString dayLabel(qint64 day) const;
+    // Drops the cached day labels at local midnight, when "Today" becomes
+    // "Yesterday", and tells the view their rows changed.
+    void scheduleDayRollover();
+    void rollOverDay();
 
-    QVector<MessageItem> m_items;
+    // Newest-first. A deque rather than a QVector: live messages land at the
+    // front and older history at the back, and both ends take a row without
+    // moving the rest, however long the thread has grown.
+    std::deque<Row> m_items;
+    // History older than the last row, oldest-first, not yet handed to the view.
+    QVector<MessageItem> m_olderHistory;
+    // One fingerprint per message the model holds, rows and held-back history
+    // alike, over what makes two messages the same one: who, when, and what.
+    // Eight bytes a message plus the set's own overhead, for a duplicate check
+    // that costs the same wherever in the thread the copy is. A match is only a
+    // candidate: holds() confirms it.
+    QSet<quint64> m_fingerprints;
+    // The senders the rows index: a thread has many rows and few senders.
+    QVector<Sender> m_senders;
+    QHash<QString, quint32> m_senderIndex;
+    // Clock time by local minute of the day, at most 1440 of them for any
+    // number of rows.
+    QHash<int, QString> m_timeLabels;
+    mutable QHash<qint64, QString> m_dayLabels;
+    QTimer* m_dayRollover;
 };
 
 #endif
@@ -0,0 +1,85 @@
+#include "ModuleRecords.h"
+
+#include "Identity.h"
+
+#include <QDateTime>
+#include <QVariantMap>
+
+namespace {
+
+// Records decoded between looks at the cancel flag: often enough that a
+// superseded thread stops within a fraction of a millisecond, seldom enough
+// that looking costs nothing.
+constexpr int kRecordsPerCancelCheck = 256;
+
+bool canceledAt(qsizetype record, const ModuleRecords::Canceled& canceled)
+{
+    return canceled && record % kRecordsPerCancelCheck == 0 && canceled();
+}
+
+} // namespace
+
+namespace ModuleRecords {
+
+QVector<MessageItem> decodeMessages(const QVariantList& records, const Canceled& canceled)
+{
+    QVector<MessageItem> thread;
+    thread.reserve(records.size());
+    for (qsizetype i = 0; i < records.size(); ++i) {
+        if (canceledAt(i, canceled))
+            return {};
+        const QVariantMap obj = records.at(i).toMap();
+        const bool fromSelf = obj.value(QStringLiteral("from_self")).toBool();
+        const QString content = obj.value(QStringLiteral("content")).toString();
+        const qint64 ts = obj.value(QStringLiteral("timestamp_ms")).toLongLong();
+        const QString sender = obj.value(QStringLiteral("sender")).toString();
+        thread.append({ fromSelf ? QStringLiteral("Me") : shortSenderLabel(sender),
+                        content, msOrNow(ts), fromSelf });
+    }
+    return thread;
+}
+
+QVector<ConversationItem> decodeConversations(const QVariantList& records, const Canceled& canceled)
+{
+    QVector<ConversationItem> conversations;
+    conversations.reserve(records.size());
+    for (qsizetype i = 0; i < records.size(); ++i) {
+        if (canceledAt(i, canceled))
+            return {};
+        const QVariantMap obj = records.at(i).toMap();
+        const QString convoId = obj.value(QStringLiteral("convo_id")).toString();
+        if (convoId.isEmpty()) continue;
+        const QString nickname = obj.value(QStringLiteral("nickname")).toString();
+        const QString name = obj.value(QStringLiteral("name")).toString();
+        const QString description = obj.value(QStringLiteral("description")).toString();
+        const QString preview = obj.value(QStringLiteral("preview")).toString();
+        const qint64 lastActivity = obj.value(QStringLiteral("last_activity_ms")).toLongLong();
+        const bool isGroup = obj.value(QStringLiteral("kind")).toString() == QStringLiteral("group");
+        // Local nickname wins, then the group's shared name, else a generated label.
+        const QString displayName = !nickname.isEmpty() ? nickname
+            : !name.isEmpty()                           ? name
+                                                        : fallbackDisplayName(convoId, QString(), isGroup);
+        conversations.append({ convoId, displayName, description,
+                               QDateTime::fromMSecsSinceEpoch(msOrNow(lastActivity)), 0, isGroup,
+                               preview });
+    }
+    return conversations;
+}
+
+qint64 msOrNow(qint64 ms)
+{
+    return ms > 0 ? ms : QDateTime::currentMSecsSinceEpoch();
+}
+
+QString fallbackDisplayName(const QString& convoId, const QString& peerLabel, bool isGroup)
+{
+    const QString label = peerLabel.isEmpty() ? Identity::shortLabel(convoId) : peerLabel;
+    return (isGroup ? QStringLiteral("Group ") : QStringLiteral("DM ")) + label;
+}
+
+QString shortSenderLabel(const QString& sender)
+{
+    return sender.isEmpty() ? QStringLiteral("Peer") : Identity::shortLabel(sender);
+}
+
+} // namespace ModuleRecords
@@ -0,0 +1,39 @@
+#ifndef MODULE_RECORDS_H
+#define MODULE_RECORDS_H
+
+#include "ConversationListModel.h"
+#include "MessageListModel.h"
+
+#include <QString>
+#include <QVariantList>
+#include <QVector>
+#include <functional>
+
+// The chat module's list replies turned into model rows. Nothing here touches a
+// QObject, so a long reply can be decoded on a worker thread while the GUI
+// thread goes on. `canceled`, when given, is asked between records and ends the
+// decode early; what it returns then is incomplete and meant to be dropped.
+namespace ModuleRecords {
+
+using Canceled = std::function<bool()>;
+
+// get_messages records, oldest-first as the module returns them.
+QVector<MessageItem> decodeMessages(const QVariantList& records, const Canceled& canceled = {});
+
+// list_conversations records. Unread counts are left at zero: the module does
+// not keep them.
+QVector<ConversationItem> decodeConversations(const QVariantList& records,
+                                              const Canceled& canceled = {});
+
+// The module's epoch milliseconds, or now when it left the timestamp out.
+qint64 msOrNow(qint64 ms);
+
+QString fallbackDisplayName(const QString& convoId, const QString& peerLabel = QString(),
+                            bool isGroup = false);
+
+// Short display form of a message sender; "Peer" when the sender is empty.
+QString shortSenderLabel(const QString& sender);
+
+} // namespace ModuleRecords
+
+#endif
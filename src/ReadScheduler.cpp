@@ -0,0 +1,138 @@
+#include "ReadScheduler.h"
+
+#include <utility>
+
+ReadScheduler::ReadScheduler()
+{
+    m_watchdog.setSingleShot(true);
+    m_watchdog.callOnTimeout([this] { expire(); });
+}
+
+void ReadScheduler::request(const QString& kind, const QString& key, Priority priority, Start start,
+                            Expired expired)
+{
+    Request request;
+    request.kind = kind;
+    request.key = key;
+    request.priority = priority;
+    request.start = std::move(start);
+    request.expired = std::move(expired);
+    request.queued.start();
+
+    for (int i = 0; i < m_waiting.size(); ++i) {
+        if (m_waiting.at(i).kind != kind) continue;
+        // The newer asking replaces it, keeping the more urgent priority and
+        // the earlier start of the wait.
+        const Request replaced = m_waiting.takeAt(i);
+        if (replaced.priority == Priority::User)
+            request.priority = Priority::User;
+        request.queued = replaced.queued;
+        break;
+    }
+    request.ticket = ++m_nextTicket;
+    m_waiting.insert(positionFor(request.priority), std::move(request));
+
+    if (!m_running)
+        runNext();
+}
+
+bool ReadScheduler::finish(quint64 ticket)
+{
+    if (!m_running || ticket != m_currentTicket) return false;
+
+    m_running = false;
+    m_watchdog.stop();
+    m_currentExpired = {};
+    m_current.ranMs = m_ran.elapsed();
+    if (m_finished)
+        m_finished(m_current);
+    runNext();
+    return true;
+}
+
+void ReadScheduler::cancel(const QString& kind)
+{
+    for (int i = 0; i < m_waiting.size(); ++i) {
+        if (m_waiting.at(i).kind == kind) {
+            m_waiting.removeAt(i);
+            return;
+        }
+    }
+}
+
+bool ReadScheduler::abandon(const QString& kind)
+{
+    if (!m_running || m_current.kind != kind) return false;
+
+    m_running = false;
+    m_watchdog.stop();
+    m_currentExpired = {};
+    m_current.ranMs = m_ran.elapsed();
+    m_current.abandoned = true;
+    if (m_finished)
+        m_finished(m_current);
+    runNext();
+    return true;
+}
+
+void ReadScheduler::setFinishedHandler(std::function<void(const Timing&)> handler)
+{
+    m_finished = std::move(handler);
+}
+
+void ReadScheduler::setTimeout(int ms)
+{
+    m_timeoutMs = ms;
+}
+
+int ReadScheduler::waiting() const
+{
+    return m_waiting.size();
+}
+
+bool ReadScheduler::isRunning() const
+{
+    return m_running;
+}
+
+int ReadScheduler::positionFor(Priority priority) const
+{
+    if (priority == Priority::Background)
+        return m_waiting.size();
+    int position = 0;
+    while (position < m_waiting.size() && m_waiting.at(position).priority == Priority::User)
+        ++position;
+    return position;
+}
+
+void ReadScheduler::runNext()
+{
+    // Running already when a handler asked for a read that went straight out.
+    if (m_running || m_waiting.isEmpty()) return;
+
+    Request next = m_waiting.takeFirst();
+    m_running = true;
+    m_currentTicket = next.ticket;
+    m_currentExpired = std::move(next.expired);
+    m_current = { next.kind, next.key, next.priority, next.queued.elapsed(), 0, false, false };
+    m_ran.start();
+    if (m_timeoutMs > 0)
+        m_watchdog.start(m_timeoutMs);
+    // Last, as the read may be answered, and finish() called, before it returns.
+    next.start(next.ticket);
+}
+
+void ReadScheduler::expire()
+{
+    if (!m_running) return;
+
+    m_running = false;
+    m_current.ranMs = m_ran.elapsed();
+    m_current.timedOut = true;
+    const Expired expired = std::exchange(m_currentExpired, {});
+    if (m_finished)
+        m_finished(m_current);
+    if (expired)
+        expired();
+    runNext();
+}
@@ -0,0 +1,102 @@
+#ifndef READ_SCHEDULER_H
+#define READ_SCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+#include <QTimer>
+#include <functional>
+
+// The order the backend's reads of the module go out in. One runs at a time,
+// as the module answers them in turn anyway; the rest wait, the user's ahead of
+// the background's. A kind of read has at most one waiting: asking again
+// replaces it, so three list refreshes in a row are one read, and a thread
+// asked for after the user has moved on takes the place of the one they left.
+// A read already out is not replaced, as its answer may predate what prompted
+// the new one. One whose answer never comes is given up on after the timeout,
+// so it cannot hold up every read behind it, and one no longer wanted can be
+// abandoned so the next goes out at once.
+//
+// Not thread-safe.
+class ReadScheduler
+{
+public:
+    enum class Priority { User, Background };
+
+    // How long a read waited for its turn and how long the module took over it,
+    // from its first asking.
+    struct Timing {
+        QString kind;
+        QString key;
+        Priority priority = Priority::Background;
+        qint64 waitedMs = 0;
+        qint64 ranMs = 0;
+        // Given up on, unanswered, at the timeout.
+        bool timedOut = false;
+        // Given up on, unanswered, by abandon().
+        bool abandoned = false;
+    };
+
+    // Issues the read, passing on the ticket it is to hand back to finish()
+    // once the module has answered, whatever the answer.
+    using Start = std::function<void(quint64 ticket)>;
+    // Told that the read it was given with timed out; its answer, should it
+    // come after all, is refused by finish().
+    using Expired = std::function<void()>;
+
+    ReadScheduler();
+
+    // Asks for a read of `kind`, for `key` within it (a conversation id, or
+    // empty). Started at once when nothing is out.
+    void request(const QString& kind, const QString& key, Priority priority, Start start,
+                 Expired expired = {});
+    // The read with `ticket` has been answered; the next one goes out. False,
+    // and ignored, for a ticket that is not the read out: its answer is to be
+    // dropped.
+    bool finish(quint64 ticket);
+    // Drops a waiting read of `kind`. One already out is left to finish.
+    void cancel(const QString& kind);
+    // Gives up on the read out if it is of `kind`, without telling its
+    // Expired, and sends the next; its answer is refused by finish(). False
+    // when no read of `kind` is out.
+    bool abandon(const QString& kind);
+
+    void setFinishedHandler(std::function<void(const Timing&)> handler);
+    // How long a read may stay out before it is given up on; zero, the
+    // default, waits for ever.
+    void setTimeout(int ms);
+
+    int waiting() const;
+    bool isRunning() const;
+
+private:
+    struct Request {
+        quint64 ticket = 0;
+        QString kind;
+        QString key;
+        Priority priority = Priority::Background;
+        Start start;
+        Expired expired;
+        QElapsedTimer queued;
+    };
+
+    // Where a request of `priority` joins the queue: behind every request at
+    // its own priority or higher.
+    int positionFor(Priority priority) const;
+    void runNext();
+    void expire();
+
+    // User requests first, then background, each in the order asked.
+    QList<Request> m_waiting;
+    bool m_running = false;
+    Timing m_current;
+    quint64 m_currentTicket = 0;
+    QElapsedTimer m_ran;
+    Expired m_currentExpired;
+    quint64 m_nextTicket = 0;
+    std::function<void(const Timing&)> m_finished;
+    QTimer m_watchdog;
+    int m_timeoutMs = 0;
+};
+
+#endif
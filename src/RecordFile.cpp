@@ -0,0 +1,32 @@
+#include "RecordFile.h"
+
+#include <QDataStream>
+
+namespace RecordFile {
+
+namespace {
+
+constexpr QDataStream::Version kStreamVersion = QDataStream::Qt_6_0;
+
+} // namespace
+
+void writeHeader(QDataStream& out, quint32 magic, quint16 format, quint32 entries)
+{
+    out.setVersion(kStreamVersion);
+    out << magic << format << entries;
+}
+
+bool readHeader(QDataStream& in, quint32 magic, quint16 format, quint32* entries)
+{
+    in.setVersion(kStreamVersion);
+    quint32 readMagic = 0;
+    quint16 readFormat = 0;
+    quint32 readEntries = 0;
+    in >> readMagic >> readFormat >> readEntries;
+    if (in.status() != QDataStream::Ok || readMagic != magic || readFormat != format)
+        return false;
+    *entries = readEntries;
+    return true;
+}
+
+} // namespace RecordFile
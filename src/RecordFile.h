@@ -0,0 +1,21 @@
+#ifndef RECORD_FILE_H
+#define RECORD_FILE_H
+
+#include <QtGlobal>
+
+class QDataStream;
+
+// The header the files this view keeps between runs start with: which file it
+// is, the layout its records are in, and how many there are. A file that is
+// not the one expected, or is from a later layout, is refused rather than
+// misread. Both calls also put the stream on the encoding the records use.
+namespace RecordFile {
+
+void writeHeader(QDataStream& out, quint32 magic, quint16 format, quint32 entries);
+// False, with `entries` untouched, when the header is unreadable or names
+// another file or layout.
+bool readHeader(QDataStream& in, quint32 magic, quint16 format, quint32* entries);
+
+} // namespace RecordFile
+
+#endif
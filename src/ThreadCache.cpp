@@ -0,0 +1,149 @@
+#include "ThreadCache.h"
+
+#include <utility>
+
+namespace {
+
+// What a QString costs beyond its characters: the header its data sits behind.
+constexpr qint64 kStringOverheadBytes = 32;
+
+} // namespace
+
+ThreadCache::ThreadCache(qint64 budgetBytes)
+    : m_budget(budgetBytes)
+{
+}
+
+void ThreadCache::setBudget(qint64 bytes)
+{
+    m_budget = bytes;
+    evictToBudget();
+}
+
+qint64 ThreadCache::budget() const
+{
+    return m_budget;
+}
+
+bool ThreadCache::lookup(const QString& convoId, QVector<MessageItem>* thread)
+{
+    const auto entry = m_entries.constFind(convoId);
+    if (entry == m_entries.cend()) {
+        ++m_misses;
+        return false;
+    }
+    ++m_hits;
+    *thread = entry->thread;
+    touch(convoId);
+    return true;
+}
+
+void ThreadCache::store(const QString& convoId, QVector<MessageItem> thread)
+{
+    remove(convoId);
+
+    const qint64 cost = costOf(thread);
+    if (cost > m_budget)
+        return;
+
+    m_entries.insert(convoId, { std::move(thread), cost });
+    m_recency.append(convoId);
+    m_bytes += cost;
+    evictToBudget();
+}
+
+bool ThreadCache::warm(const QString& convoId, QVector<MessageItem> thread, qint64 ceilingBytes)
+{
+    if (m_entries.contains(convoId))
+        return false;
+    const qint64 cost = costOf(thread);
+    if (m_bytes + cost > qMin(m_budget, ceilingBytes))
+        return false;
+
+    m_entries.insert(convoId, { std::move(thread), cost });
+    m_recency.prepend(convoId);
+    m_bytes += cost;
+    return true;
+}
+
+void ThreadCache::append(const QString& convoId, const MessageItem& message)
+{
+    const auto entry = m_entries.find(convoId);
+    if (entry == m_entries.end())
+        return;
+    const qint64 cost = costOf(message);
+    entry->thread.append(message);
+    entry->bytes += cost;
+    m_bytes += cost;
+    evictToBudget();
+}
+
+void ThreadCache::remove(const QString& convoId)
+{
+    const auto entry = m_entries.find(convoId);
+    if (entry == m_entries.end())
+        return;
+    m_bytes -= entry->bytes;
+    m_entries.erase(entry);
+    m_recency.removeOne(convoId);
+}
+
+void ThreadCache::clear()
+{
+    m_entries.clear();
+    m_recency.clear();
+    m_bytes = 0;
+}
+
+bool ThreadCache::contains(const QString& convoId) const
+{
+    return m_entries.contains(convoId);
+}
+
+int ThreadCache::size() const
+{
+    return static_cast<int>(m_entries.size());
+}
+
+qint64 ThreadCache::bytes() const
+{
+    return m_bytes;
+}
+
+int ThreadCache::hits() const
+{
+    return m_hits;
+}
+
+int ThreadCache::misses() const
+{
+    return m_misses;
+}
+
+qint64 ThreadCache::costOf(const MessageItem& message)
+{
+    return static_cast<qint64>(sizeof(MessageItem)) + 2 * kStringOverheadBytes
+        + (message.sender.size() + message.content.size()) * static_cast<qint64>(sizeof(QChar));
+}
+
+qint64 ThreadCache::costOf(const QVector<MessageItem>& thread)
+{
+    qint64 cost = 0;
+    for (const MessageItem& message : thread)
+        cost += costOf(message);
+    return cost;
+}
+
+void ThreadCache::touch(const QString& convoId)
+{
+    m_recency.removeOne(convoId);
+    m_recency.append(convoId);
+}
+
+void ThreadCache::evictToBudget()
+{
+    while (m_bytes > m_budget && !m_recency.isEmpty()) {
+        const QString oldest = m_recency.first();
+        remove(oldest);
+    }
+}
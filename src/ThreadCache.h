@@ -0,0 +1,75 @@
+#ifndef THREAD_CACHE_H
+#define THREAD_CACHE_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include "MessageListModel.h"
+
+// Threads the user has recently had on screen, so switching back to one shows
+// it without waiting on the module. Bounded by an estimate of the memory the
+// threads hold rather than by their number: a busy group and a quiet DM are
+// not the same cost. The thread least recently looked up or stored goes first.
+//
+// A cached thread is kept current by appending the live messages that arrive
+// for it, on screen or not; it is still only as fresh as what this process
+// heard, so a caller revalidates a hit against the module.
+//
+// Not thread-safe.
+class ThreadCache
+{
+public:
+    static constexpr qint64 kDefaultBudgetBytes = 32 * 1024 * 1024;
+
+    explicit ThreadCache(qint64 budgetBytes = kDefaultBudgetBytes);
+
+    // Lowering the budget evicts down to it at once.
+    void setBudget(qint64 bytes);
+    qint64 budget() const;
+
+    // Copies the cached thread for `convoId`, oldest first, into `thread` and
+    // makes it the most recent. False when it is not cached. Either way it
+    // counts towards hits() or misses().
+    bool lookup(const QString& convoId, QVector<MessageItem>* thread);
+    // Caches `thread`, oldest first, as the most recent, replacing what was
+    // there. A thread larger than the whole budget is not kept.
+    void store(const QString& convoId, QVector<MessageItem> thread);
+    // Caches a thread read ahead of the user asking for it, as the least
+    // recent, and only while the cache stays within `ceilingBytes` and the
+    // budget, whichever is lower: it must not push out a thread that was on
+    // screen, nor replace one cached already. False when it was not kept.
+    bool warm(const QString& convoId, QVector<MessageItem> thread, qint64 ceilingBytes);
+    // Appends a live message to a cached thread; a no-op for one not cached.
+    void append(const QString& convoId, const MessageItem& message);
+    void remove(const QString& convoId);
+    void clear();
+
+    bool contains(const QString& convoId) const;
+    int size() const;
+    qint64 bytes() const;
+    int hits() const;
+    int misses() const;
+
+private:
+    struct Entry {
+        QVector<MessageItem> thread;
+        qint64 bytes = 0;
+    };
+
+    static qint64 costOf(const MessageItem& message);
+    static qint64 costOf(const QVector<MessageItem>& thread);
+    void touch(const QString& convoId);
+    void evictToBudget();
+
+    QHash<QString, Entry> m_entries;
+    // Least recent first.
+    QList<QString> m_recency;
+    qint64 m_budget;
+    qint64 m_bytes = 0;
+    int m_hits = 0;
+    int m_misses = 0;
+};
+
+#endif
@@ -0,0 +1,98 @@
+#include "UnreadStore.h"
+
+#include "RecordFile.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+namespace {
+
+// "URC1": unread counts, one conversation id and count per record.
+constexpr quint32 kMagic = 0x55524331;
+constexpr quint16 kFormat = 1;
+
+} // namespace
+
+bool UnreadStore::open(const QString& directory)
+{
+    m_counts.clear();
+    m_dirty = false;
+    m_path = QDir(directory).filePath(QString::fromLatin1(kFileName));
+
+    QFile file(m_path);
+    if (!file.exists())
+        return true;
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 entries = 0;
+    if (!RecordFile::readHeader(in, kMagic, kFormat, &entries))
+        return false;
+
+    QHash<QString, int> counts;
+    for (quint32 i = 0; i < entries && in.status() == QDataStream::Ok; ++i) {
+        QString convoId;
+        qint32 count = 0;
+        in >> convoId >> count;
+        if (count > 0)
+            counts.insert(convoId, count);
+    }
+    if (in.status() != QDataStream::Ok)
+        return false;
+    m_counts = std::move(counts);
+    return true;
+}
+
+bool UnreadStore::save()
+{
+    if (!m_dirty || m_path.isEmpty())
+        return true;
+
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    QDataStream out(&file);
+    RecordFile::writeHeader(out, kMagic, kFormat, quint32(m_counts.size()));
+    for (auto it = m_counts.cbegin(); it != m_counts.cend(); ++it)
+        out << it.key() << qint32(it.value());
+    if (out.status() != QDataStream::Ok || !file.commit())
+        return false;
+    m_dirty = false;
+    return true;
+}
+
+int UnreadStore::count(const QString& convoId) const
+{
+    return m_counts.value(convoId);
+}
+
+void UnreadStore::set(const QString& convoId, int count)
+{
+    if (count <= 0) {
+        if (m_counts.remove(convoId))
+            m_dirty = true;
+        return;
+    }
+    int& stored = m_counts[convoId];
+    if (stored == count) return;
+    stored = count;
+    m_dirty = true;
+}
+
+QStringList UnreadStore::conversations() const
+{
+    return m_counts.keys();
+}
+
+bool UnreadStore::isDirty() const
+{
+    return m_dirty;
+}
+
+QString UnreadStore::path() const
+{
+    return m_path;
+}
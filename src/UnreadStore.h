@@ -0,0 +1,43 @@
+#ifndef UNREAD_STORE_H
+#define UNREAD_STORE_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+// The unread count of each conversation with one, kept on disk so the badges
+// survive a restart. Changes are held in memory until save(): a burst of
+// messages is one write, not one per message. The file is replaced whole and
+// atomically, so a crash mid-save leaves the last one intact.
+//
+// Not thread-safe.
+class UnreadStore
+{
+public:
+    static constexpr const char* kFileName = "chat_ui_unread.dat";
+
+    // Reads the counts saved under `directory`, replacing those in memory, and
+    // saves there from now on. A missing file is an empty store; false when the
+    // file is there but unreadable, leaving the store empty.
+    bool open(const QString& directory);
+    // Writes the counts if they changed since the last save. False when that
+    // failed; they stay unsaved, to be tried again.
+    bool save();
+
+    int count(const QString& convoId) const;
+    // A count of zero forgets the conversation.
+    void set(const QString& convoId, int count);
+    QStringList conversations() const;
+
+    // Whether there are changes save() has yet to write.
+    bool isDirty() const;
+    // The file, empty until open().
+    QString path() const;
+
+private:
+    QHash<QString, int> m_counts;
+    QString m_path;
+    bool m_dirty = false;
+};
+
+#endif
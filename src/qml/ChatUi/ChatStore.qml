@@ -13,6 +13,8 @@ QtObject {
 
     readonly property var backend: typeof logos !== "undefined" && logos ? logos.module("chat_ui") : null
     readonly property var conversationModel: typeof logos !== "undefined" && logos ? logos.model("chat_ui", "conversationModel") : null
+    // The conversations matching the last setConversationFilter query.
+    readonly property var conversationSearchModel: typeof logos !== "undefined" && logos ? logos.model("chat_ui", "conversationSearchModel") : null
     readonly property var messageModel: typeof logos !== "undefined" && logos ? logos.model("chat_ui", "messageModel") : null
     readonly property var memberModel: typeof logos !== "undefined" && logos ? logos.model("chat_ui", "memberModel") : null
 
@@ -39,6 +41,9 @@ QtObject {
     readonly property var errors: backend ? backend.errors : []
     readonly property var logRuns: backend ? backend.logRuns : []
     readonly property string logDir: backend ? backend.logDir : ""
+    // The conversations are the last run's, listed until the module has been
+    // read.
+    readonly property bool conversationsStale: backend ? backend.conversationsStale : false
 
     // Short connectivity label for the account card.
     readonly property string statusLabel: {
@@ -72,6 +77,14 @@ QtObject {
         if (backend && currentConversationId !== "")
             backend.sendMessage(currentConversationId, text);
     }
+    function fetchOlderMessages() {
+        if (backend)
+            backend.fetchOlderMessages();
+    }
+    function setConversationFilter(query) {
+        if (backend)
+            backend.setConversationFilter(query);
+    }
     function createConversation(address) {
         if (backend)
             backend.createConversation(address);
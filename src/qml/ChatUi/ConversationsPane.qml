@@ -7,21 +7,27 @@ import QtQuick.Layouts
 import Logos.Theme
 import Logos.Controls
 
-// The conversations card: the one action that starts a conversation, over the
-// keyboard-navigable list of the ones already open. Data in via properties,
-// intent out via signals.
+// The conversations card: the one action that starts a conversation and a
+// search over the keyboard-navigable list of the ones already open. Data in via
+// properties, intent out via signals.
 Rectangle {
     id: root
 
     required property var conversationModel
+    // The matches for the last searchChanged query, listed instead of
+    // conversationModel while the search field has text in it.
+    required property var conversationSearchModel
     required property string currentConversationId
     required property bool online
+    // The list is the last run's, shown while the current one is read.
+    property bool stale: false
 
     // Carries the selected row's own data, so a view can render the selection
     // before the backend has switched to it.
     signal conversationSelected(var conversation)
     signal newConversationRequested
     signal newGroupRequested
+    signal searchChanged(string query)
 
     // Exposed for the exchange doc-test's inspector hooks.
     property alias count: convList.count
@@ -36,6 +42,8 @@ Rectangle {
     QtObject {
         id: d
 
+        readonly property bool searching: searchField.text.trim() !== ""
+
         // Select the keyboard-focused row, giving it the same effect as a click.
         function activateCurrent() {
             const row = convList.currentItem as ConversationDelegate;
@@ -101,6 +109,15 @@ Rectangle {
             }
         }
 
+        LogosTextField {
+            id: searchField
+            objectName: "conversationSearchField"
+            Layout.fillWidth: true
+            //: Placeholder of the field that narrows the conversation list
+            placeholderText: qsTr("Search conversations")
+            onTextChanged: root.searchChanged(text.trim())
+        }
+
         ListView {
             id: convList
             objectName: "conversationList"
@@ -110,8 +127,11 @@ Rectangle {
             focus: true
             reuseItems: true
             spacing: Theme.spacing.tiny
-            model: root.conversationModel
+            model: d.searching ? root.conversationSearchModel : root.conversationModel
             currentIndex: -1
+            // Drawn back until the module confirms it, so what may have changed
+            // since does not read as current.
+            opacity: root.stale ? 0.6 : 1
 
             Keys.onReturnPressed: d.activateCurrent()
             Keys.onEnterPressed: d.activateCurrent()
@@ -130,7 +150,7 @@ Rectangle {
                 anchors.centerIn: parent
                 width: parent.width - 2 * Theme.spacing.medium
                 visible: convList.count === 0
-                text: root.online ? qsTr("No conversations yet. Use New chat to start one, or share your address so someone can reach you.") : qsTr("Waiting for connection...")
+                text: d.searching ? qsTr("No conversations match.") : root.online ? qsTr("No conversations yet. Use New chat to start one, or share your address so someone can reach you.") : qsTr("Waiting for connection...")
             }
         }
     }
@@ -40,6 +40,9 @@ Rectangle {
     required property bool ready
 
     signal messageSubmitted(string text)
+    // The thread has been scrolled up to its oldest row, so the next page of
+    // older history is wanted.
+    signal olderMessagesRequested
     // Requests the conversation's details; emitted from the header's toggle.
     signal detailsRequested
 
@@ -152,6 +155,11 @@ Rectangle {
                 verticalLayoutDirection: ListView.BottomToTop
                 visible: root.threadReady
 
+                // Bottom-to-top, so the visual top is the model's end: the oldest
+                // row loaded, with any older history still to be fetched.
+                onAtYBeginningChanged: if (atYBeginning && count > 0 && root.threadReady)
+                    root.olderMessagesRequested()
+
                 header: Item {
                     height: Theme.spacing.medium
                 }
@@ -88,6 +88,8 @@ Rectangle {
                     Layout.fillWidth: true
                     Layout.fillHeight: true
                     conversationModel: store.conversationModel
+                    conversationSearchModel: store.conversationSearchModel
+                    stale: store.conversationsStale
                     currentConversationId: root.selectedConversationId
                     online: store.online
                     onConversationSelected: function (conversation) {
@@ -96,6 +98,9 @@ Rectangle {
                     }
                     onNewConversationRequested: newConvDialog.open()
                     onNewGroupRequested: newGroupDialog.open()
+                    onSearchChanged: function (query) {
+                        store.setConversationFilter(query);
+                    }
                 }
 
                 AccountCard {
@@ -132,6 +137,7 @@ Rectangle {
                 onMessageSubmitted: function (text) {
                     store.sendMessage(text);
                 }
+                onOlderMessagesRequested: store.fetchOlderMessages()
                 onDetailsRequested: root.detailsShown = !root.detailsShown
             }
 
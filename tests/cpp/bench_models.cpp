@@ -0,0 +1,471 @@
+#include <QDateTime>
+#include <QSortFilterProxyModel>
+#include <QTest>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#if __GLIBC_PREREQ(2, 33)
+#define HAVE_MALLINFO2
+#endif
+#endif
+
+#include "ConversationListModel.h"
+#include "MemberListModel.h"
+#include "MessageListModel.h"
+
+// How the models on the hot path scale with the rows they hold. Each benchmark
+// is data-driven over the row count, so a cost that grows with the model shows
+// as a climb across the rows rather than as one slow number. For each model:
+// filling it, updating one row by its id, replacing every row, and reading
+// every role of every row as a view scrolled end to end would.
+//
+// Run with `-o bench.xml,xml` (ctest does) for results a later run can be
+// compared against.
+class BenchModels : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void liveMessagesIntoABacklog_data();
+    void liveMessagesIntoABacklog();
+    void heapBytesPerMessageRow_data();
+    void heapBytesPerMessageRow();
+    void messageIntoAConversationList_data();
+    void messageIntoAConversationList();
+    void activityThroughASortProxy_data();
+    void activityThroughASortProxy();
+    void conversationsAddedOneByOne_data();
+    void conversationsAddedOneByOne();
+    void conversationBumpedToTheTop_data();
+    void conversationBumpedToTheTop();
+    void conversationListReconciledFromEmpty_data();
+    void conversationListReconciledFromEmpty();
+    void conversationRolesOfEveryRow_data();
+    void conversationRolesOfEveryRow();
+    void threadLoaded_data();
+    void threadLoaded();
+    void threadRevalidated_data();
+    void threadRevalidated();
+    void messageRolesOfEveryRow_data();
+    void messageRolesOfEveryRow();
+    void rosterSet_data();
+    void rosterSet();
+    void rosterRefreshedWithOneChange_data();
+    void rosterRefreshedWithOneChange();
+    void memberLookedUpByAddress_data();
+    void memberLookedUpByAddress();
+    void memberRolesOfEveryRow_data();
+    void memberRolesOfEveryRow();
+
+private:
+    // One second of a busy thread.
+    static constexpr int kArrivalsPerSecond = 1000;
+
+    static void addRowCounts();
+    // A thread of `count` messages loaded all the way back, as after the user
+    // has scrolled through its history.
+    static void loadWholeThread(MessageListModel& model, int count);
+    static QVector<MessageItem> thread(int count);
+    // A read of `count` conversations, a second of activity apart.
+    static QVector<ConversationItem> conversations(int count);
+    static void fillConversations(ConversationListModel& model, int count);
+    // A roster of `count` members, every tenth an uncommitted invite.
+    static QVector<MemberItem> roster(int count);
+    // Every role of every row, as the delegates of a view scrolled over the
+    // whole model would ask. Returns how many came back set, so the reads are
+    // not optimised away.
+    static int readEveryRole(const QAbstractItemModel& model);
+};
+
+void BenchModels::addRowCounts()
+{
+    QTest::addColumn<int>("rows");
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+}
+
+void BenchModels::loadWholeThread(MessageListModel& model, int count)
+{
+    model.setMessages(thread(count));
+    while (model.canFetchMore(QModelIndex()))
+        model.fetchMore(QModelIndex());
+}
+
+QVector<MessageItem> BenchModels::thread(int count)
+{
+    const qint64 start = QDateTime(QDate(2026, 7, 1), QTime(9, 0)).toMSecsSinceEpoch();
+    QVector<MessageItem> items;
+    items.reserve(count);
+    for (int i = 0; i < count; ++i)
+        items.append({ QStringLiteral("alice"), QString::number(i), start + i * 1000, false });
+    return items;
+}
+
+QVector<ConversationItem> BenchModels::conversations(int count)
+{
+    const QDateTime start(QDate(2026, 7, 1), QTime(9, 0));
+    QVector<ConversationItem> items;
+    items.reserve(count);
+    for (int i = 0; i < count; ++i)
+        items.append({ QString::number(i), QStringLiteral("DM %1").arg(i), QString(), start.addSecs(i), 0,
+                       false, QStringLiteral("hi") });
+    return items;
+}
+
+void BenchModels::fillConversations(ConversationListModel& model, int count)
+{
+    model.reconcile(conversations(count));
+}
+
+QVector<MemberItem> BenchModels::roster(int count)
+{
+    QVector<MemberItem> members;
+    members.reserve(count);
+    for (int i = 0; i < count; ++i)
+        members.append({ QStringLiteral("0x%1").arg(i, 40, 16, QLatin1Char('0')), i == 0, i % 10 == 9 });
+    return members;
+}
+
+int BenchModels::readEveryRole(const QAbstractItemModel& model)
+{
+    const QList<int> roles = model.roleNames().keys();
+    int set = 0;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        const QModelIndex at = model.index(row, 0);
+        for (int role : roles)
+            set += model.data(at, role).isValid();
+    }
+    return set;
+}
+
+void BenchModels::liveMessagesIntoABacklog_data()
+{
+    addRowCounts();
+}
+
+void BenchModels::liveMessagesIntoABacklog()
+{
+    QFETCH(int, rows);
+    MessageListModel model;
+    loadWholeThread(model, rows);
+    QCOMPARE(model.rowCount(), rows);
+
+    // Every arrival is newer than the backlog and than the one before it, so
+    // each lands on top and none is dropped as a duplicate.
+    const qint64 after = QDateTime(QDate(2026, 8, 1), QTime(9, 0)).toMSecsSinceEpoch();
+    qint64 arrived = 0;
+    QBENCHMARK {
+        for (int i = 0; i < kArrivalsPerSecond; ++i, ++arrived)
+            model.addMessage(QStringLiteral("bob"), QString::number(arrived),
+                             after + arrived, false);
+    }
+}
+
+void BenchModels::heapBytesPerMessageRow_data()
+{
+    addRowCounts();
+}
+
+void BenchModels::heapBytesPerMessageRow()
+{
+#ifdef HAVE_MALLINFO2
+    QFETCH(int, rows);
+    // Reported through the benchmark result rather than timed: the heap the
+    // model holds once the whole thread is in, per row. The sender is built
+    // per message, as decoding the module's reply builds it, so interning it
+    // shows; the content is in every row whatever the layout.
+    const size_t before = mallinfo2().uordblks;
+    {
+        MessageListModel model;
+        const qint64 start = QDateTime(QDate(2026, 7, 1), QTime(9, 0)).toMSecsSinceEpoch();
+        QVector<MessageItem> items;
+        items.reserve(rows);
+        for (int i = 0; i < rows; ++i)
+            items.append({ QString::fromLatin1("alice"), QString::number(i), start + i * 1000, false });
+        model.setMessages(std::move(items));
+        while (model.canFetchMore(QModelIndex()))
+            model.fetchMore(QModelIndex());
+        QCOMPARE(model.rowCount(), rows);
+        const size_t held = mallinfo2().uordblks - before;
+        QTest::setBenchmarkResult(qreal(held) / rows, QTest::BytesAllocated);
+    }
+#else
+    QSKIP("Reading the heap needs glibc's mallinfo2");
+#endif
+}
+
+void BenchModels::messageIntoAConversationList_data()
+{
+    addRowCounts();
+}
+
+void BenchModels::messageIntoAConversationList()
+{
+    QFETCH(int, rows);
+    ConversationListModel model;
+    const QDateTime start(QDate(2026, 7, 1), QTime(9, 0));
+    for (int i = 0; i < rows; ++i)
+        model.addConversation(QString::number(i), QStringLiteral("DM %1").arg(i), QString(),
+                              start.addSecs(i), false, QString());
+    // The last row, where a scan for the id takes longest.
+    const QString id = QString::number(rows - 1);
+    const QDateTime when(QDate(2026, 8, 1), QTime(9, 0));
+    const QString preview = QStringLiteral("hi");
+
+    // The per-id calls one incoming message makes: applyMessageReceived's,
+    // then the meta sync when it is the conversation on screen.
+    QBENCHMARK {
+        for (int i = 0; i < kArrivalsPerSecond; ++i) {
+            if (!model.contains(id))
+                QFAIL("conversation lost");
+            model.updateLastActivity(id, when);
+            model.updatePreview(id, preview);
+            model.incrementUnread(id);
+            model.isGroupFor(id);
+            model.displayNameFor(id);
+            model.descriptionFor(id);
+        }
+    }
+}
+
+void BenchModels::activityThroughASortProxy_data()
+{
+    addRowCounts();
+}
+
+void BenchModels::activityThroughASortProxy()
+{
+    // The baseline messageIntoAConversationList is measured against: the same
+    // activity, kept in recency order by a sorting proxy over the model, as
+    // the view's list once was.
+    QFETCH(int, rows);
+    ConversationListModel model;
+    fillConversations(model, rows);
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.setSortRole(ConversationListModel::LastActivityRole);
+    proxy.setDynamicSortFilter(true);
+    proxy.sort(0, Qt::DescendingOrder);
+    QDateTime when(QDate(2026, 8, 1), QTime(9, 0));
+
+    // A different conversation each time, from the bottom of the list to the top.
+    int next = 0;
+    QBENCHMARK {
+        for (int i = 0; i < kArrivalsPerSecond; ++i, ++next) {
+            when = when.addSecs(1);
+            model.updateLastActivity(QString::number(next % rows), when);
+        }
+    }
+    QCOMPARE(proxy.data(proxy.index(0, 0), ConversationListModel::ConversationIdRole).toString(),
+             QString::number((next - 1) % rows));
+}
+
+void BenchModels::conversationsAddedOneByOne_data()
+{
+    addRowCounts();
+}
+
+void BenchModels::conversationsAddedOneByOne()
+{
+    // Each one newer than the last, as conversation_created delivers them.
+    QFETCH(int, rows);
+    const QDateTime start(QDate(2026, 7, 1), QTime(9, 0));
+    QBENCHMARK {
+        ConversationListModel model;
+        for (int i = 0; i < rows; ++i)
+            model.addConversation(QString::number(i), QStringLiteral("DM %1").arg(i), QString(),
+                                  start.addSecs(i), false, QString());
+        QCOMPARE(model.rowCount(), rows);
+    }
+}
+
+void BenchModels::conversationBumpedToTheTop_data()
+{
+    addRowCounts();
+}
+
+void BenchModels::conversationBumpedToTheTop()
+{
+    // A message in the least recent conversation, the longest move there is.
+    QFETCH(int, rows);
+    ConversationListModel model;
+    fillConversations(model, rows);
+    QDateTime when = QDateTime(QDate(2026, 7, 1), QTime(9, 0)).addSecs(rows);
+    QBENCHMARK {
+        const QString bottom = model.data(model.index(rows - 1), ConversationListModel::ConversationIdRole).toString();
+        when = when.addSecs(1);
+        model.applyActivity(bottom, when, QStringLiteral("hi"), true);
+    }
+    QCOMPARE(model.rowCount(), rows);
+}
+
+void BenchModels::conversationListReconciledFromEmpty_data()
+{
+    addRowCounts();
+}
+
+void BenchModels::conversationListReconciledFromEmpty()
+{
+    // The first read of the list after start-up.
+    QFETCH(int, rows);
+    const QVector<ConversationItem> read = conversations(rows);
+    QBENCHMARK {
+        ConversationListModel model;
+        model.reconcile(read);
+        QCOMPARE(model.rowCount(), rows);
+    }
+}
+
+void BenchModels::conversationRolesOfEveryRow_data()
+{
+    addRowCounts();
+}
+
+void BenchModels::conversationRolesOfEveryRow()
+{
+    QFETCH(int, rows);
+    ConversationListModel model;
+    fillConversations(model, rows);
+    int set = 0;
+    QBENCHMARK {
+        set = readEveryRole(model);
+    }
+    QVERIFY(set >= rows);
+}
+
+void BenchModels::threadLoaded_data()
+{
+    addRowCounts();
+}
+
+void BenchModels::threadLoaded()
+{
+    // Opening a thread: its newest page in, then every older one as the user
+    // scrolls to the start.
+    QFETCH(int, rows);
+    const QVector<MessageItem> read = thread(rows);
+    MessageListModel model;
+    QBENCHMARK {
+        model.setMessages(read);
+        while (model.canFetchMore(QModelIndex()))
+            model.fetchMore(QModelIndex());
+    }
+    QCOMPARE(model.rowCount(), rows);
+}
+
+void BenchModels::threadRevalidated_data()
+{
+    addRowCounts();
+}
+
+void BenchModels::threadRevalidated()
+{
+    // A cached thread checked against a fresh read that differs by one new
+    // message: every row is matched to its own by fingerprint.
+    QFETCH(int, rows);
+    MessageListModel model;
+    loadWholeThread(model, rows);
+    QVector<MessageItem> read = thread(rows);
+    read.append({ QStringLiteral("bob"), QStringLiteral("new"),
+                  QDateTime(QDate(2026, 8, 1), QTime(9, 0)).toMSecsSinceEpoch(), false });
+    QBENCHMARK {
+        model.reconcile(read);
+    }
+    QVERIFY(model.rowCount() > 0);
+}
+
+void BenchModels::messageRolesOfEveryRow_data()
+{
+    addRowCounts();
+}
+
+void BenchModels::messageRolesOfEveryRow()
+{
+    QFETCH(int, rows);
+    MessageListModel model;
+    loadWholeThread(model, rows);
+    int set = 0;
+    QBENCHMARK {
+        set = readEveryRole(model);
+    }
+    QVERIFY(set >= rows);
+}
+
+void BenchModels::rosterSet_data()
+{
+    addRowCounts();
+}
+
+void BenchModels::rosterSet()
+{
+    QFETCH(int, rows);
+    const QVector<MemberItem> members = roster(rows);
+    QBENCHMARK {
+        MemberListModel model;
+        model.setMembers(members);
+        QCOMPARE(model.rowCount(), rows);
+    }
+}
+
+void BenchModels::rosterRefreshedWithOneChange_data()
+{
+    addRowCounts();
+}
+
+void BenchModels::rosterRefreshedWithOneChange()
+{
+    // A refresh after members_changed: the roster as it was, but for one invite
+    // the group has since committed. Alternates, so each refresh is a change.
+    QFETCH(int, rows);
+    MemberListModel model;
+    QVector<MemberItem> members = roster(rows);
+    model.setMembers(members);
+    QBENCHMARK {
+        members[rows - 1].pending = !members.at(rows - 1).pending;
+        model.setMembers(members);
+    }
+    QCOMPARE(model.rowCount(), rows);
+}
+
+void BenchModels::memberLookedUpByAddress_data()
+{
+    addRowCounts();
+}
+
+void BenchModels::memberLookedUpByAddress()
+{
+    // The check an add-member dialog makes as its address is typed, for the
+    // last row, where a scan takes longest.
+    QFETCH(int, rows);
+    MemberListModel model;
+    const QVector<MemberItem> members = roster(rows);
+    model.setMembers(members);
+    const QString address = members.at(rows - 2).address;
+    QBENCHMARK {
+        for (int i = 0; i < kArrivalsPerSecond; ++i) {
+            if (!model.contains(address))
+                QFAIL("member lost");
+        }
+    }
+}
+
+void BenchModels::memberRolesOfEveryRow_data()
+{
+    addRowCounts();
+}
+
+void BenchModels::memberRolesOfEveryRow()
+{
+    QFETCH(int, rows);
+    MemberListModel model;
+    model.setMembers(roster(rows));
+    int set = 0;
+    QBENCHMARK {
+        set = readEveryRole(model);
+    }
+    QVERIFY(set >= rows);
+}
+
+QTEST_MAIN(BenchModels)
+#include "bench_models.moc"
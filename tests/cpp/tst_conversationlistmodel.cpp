@@ -0,0 +1,276 @@
+#include <QDateTime>
+#include <QSignalSpy>
+#include <QTest>
+#include <algorithm>
+
+#include "ConversationListModel.h"
+#include "Identity.h"
+
+class TestConversationListModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void findsEachRowAfterARemoval();
+    void keepsTheMostRecentFirst();
+    void appliesAMessageAsOneChange();
+    void reconcilesKeepingUnreadCounts();
+    void reconcilesAnUpdateAsOneRowsRoles();
+    void reconcilesSeveralMovesInOrder();
+    void listsTheLatestFirstAmongTheAsRecent();
+    void sumsUnreadCountsAsTheyChange();
+    void derivesAvatarAndLabelAsTheRowGoesIn();
+    void listsTheTopAndTheUnreadAsLikelyNext();
+
+private:
+    // Conversations "0".."count-1", a minute apart, so listed in reverse.
+    static void fill(ConversationListModel& model, int count);
+    static ConversationItem item(const QString& id);
+};
+
+void TestConversationListModel::fill(ConversationListModel& model, int count)
+{
+    for (int i = 0; i < count; ++i)
+        model.addConversation(QString::number(i), QStringLiteral("DM %1").arg(i), QString(),
+                              QDateTime(QDate(2026, 7, 30), QTime(9, i)), false, QString());
+}
+
+ConversationItem TestConversationListModel::item(const QString& id)
+{
+    return { id, QStringLiteral("DM ") + id, QString(), QDateTime(QDate(2026, 7, 30), QTime(9, 0)),
+             0, false, QString() };
+}
+
+void TestConversationListModel::findsEachRowAfterARemoval()
+{
+    ConversationListModel model;
+    fill(model, 5);
+
+    model.removeConversation(QStringLiteral("1"));
+
+    QVERIFY(!model.contains(QStringLiteral("1")));
+    QCOMPARE(model.indexOf(QStringLiteral("4")), 0);
+    QCOMPARE(model.indexOf(QStringLiteral("2")), 2);
+    QCOMPARE(model.indexOf(QStringLiteral("0")), 3);
+    QCOMPARE(model.displayNameFor(QStringLiteral("0")), QStringLiteral("DM 0"));
+    // No activity at all, so last, in the row the removal freed.
+    model.addConversation(QStringLiteral("5"), QStringLiteral("DM 5"), QString(), QDateTime(), false, QString());
+    QCOMPARE(model.indexOf(QStringLiteral("5")), 4);
+
+    model.clear();
+    QCOMPARE(model.indexOf(QStringLiteral("0")), -1);
+}
+
+void TestConversationListModel::keepsTheMostRecentFirst()
+{
+    ConversationListModel model;
+    fill(model, 3);
+    QSignalSpy moved(&model, &QAbstractItemModel::rowsMoved);
+
+    model.updateLastActivity(QStringLiteral("0"), QDateTime(QDate(2026, 7, 30), QTime(10, 0)));
+
+    QCOMPARE(moved.size(), 1);
+    QCOMPARE(moved.first().at(1).toInt(), 2);
+    QCOMPARE(moved.first().at(4).toInt(), 0);
+    QCOMPARE(model.indexOf(QStringLiteral("0")), 0);
+    QCOMPARE(model.indexOf(QStringLiteral("2")), 1);
+    QCOMPARE(model.indexOf(QStringLiteral("1")), 2);
+
+    // Back down past both, named by the row it goes above as the move began.
+    model.updateLastActivity(QStringLiteral("0"), QDateTime(QDate(2026, 7, 30), QTime(8, 0)));
+    QCOMPARE(moved.size(), 2);
+    QCOMPARE(moved.last().at(4).toInt(), 3);
+    QCOMPARE(model.indexOf(QStringLiteral("0")), 2);
+
+    // Activity that leaves it in place moves nothing.
+    model.updateLastActivity(QStringLiteral("0"), QDateTime(QDate(2026, 7, 30), QTime(8, 30)));
+    QCOMPARE(moved.size(), 2);
+}
+
+void TestConversationListModel::appliesAMessageAsOneChange()
+{
+    ConversationListModel model;
+    fill(model, 3);
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+    QSignalSpy moved(&model, &QAbstractItemModel::rowsMoved);
+
+    model.applyActivity(QStringLiteral("0"), QDateTime(QDate(2026, 7, 30), QTime(10, 0)),
+                        QStringLiteral("hi"), true);
+
+    QCOMPARE(changed.size(), 1);
+    QList<int> roles = changed.first().at(2).value<QList<int>>();
+    std::sort(roles.begin(), roles.end());
+    QCOMPARE(roles, (QList<int>{ ConversationListModel::LastActivityRole,
+                                 ConversationListModel::UnreadCountRole,
+                                 ConversationListModel::LastActivityDisplayRole,
+                                 ConversationListModel::PreviewRole }));
+    QCOMPARE(moved.size(), 1);
+    QCOMPARE(model.indexOf(QStringLiteral("0")), 0);
+    QCOMPARE(model.data(model.index(0), ConversationListModel::UnreadCountRole).toInt(), 1);
+
+    // The same activity again only counts the message.
+    model.applyActivity(QStringLiteral("0"), QDateTime(QDate(2026, 7, 30), QTime(10, 0)),
+                        QStringLiteral("hi"), true);
+    QCOMPARE(changed.size(), 2);
+    QCOMPARE(changed.last().at(2).value<QList<int>>(), QList<int>{ ConversationListModel::UnreadCountRole });
+}
+
+void TestConversationListModel::reconcilesKeepingUnreadCounts()
+{
+    ConversationListModel model;
+    fill(model, 3);
+    model.incrementUnread(QStringLiteral("2"));
+    model.incrementUnread(QStringLiteral("2"));
+    QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+
+    // Reordered, one gone, one new and one listed twice.
+    model.reconcile({ item(QStringLiteral("2")), item(QStringLiteral("0")),
+                      item(QStringLiteral("2")), item(QStringLiteral("3")) });
+
+    QCOMPARE(reset.size(), 0);
+    QCOMPARE(model.rowCount(), 3);
+    // All three at 9:00 now, the newcomer on top as the latest to say so.
+    QCOMPARE(model.indexOf(QStringLiteral("3")), 0);
+    QCOMPARE(model.indexOf(QStringLiteral("2")), 1);
+    QCOMPARE(model.indexOf(QStringLiteral("0")), 2);
+    QCOMPARE(model.indexOf(QStringLiteral("1")), -1);
+    QCOMPARE(model.data(model.index(1), ConversationListModel::UnreadCountRole).toInt(), 2);
+}
+
+void TestConversationListModel::reconcilesAnUpdateAsOneRowsRoles()
+{
+    ConversationListModel model;
+    QVector<ConversationItem> read{ item(QStringLiteral("0")), item(QStringLiteral("1")),
+                                    item(QStringLiteral("2")) };
+    model.reconcile(read);
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+
+    read[1].displayName = QStringLiteral("Renamed");
+    model.reconcile(read);
+
+    QCOMPARE(inserted.size(), 0);
+    QCOMPARE(removed.size(), 0);
+    QCOMPARE(changed.size(), 1);
+    QCOMPARE(changed.first().at(0).toModelIndex().row(), 1);
+    QCOMPARE(changed.first().at(2).value<QList<int>>(), QList<int>{ ConversationListModel::DisplayNameRole });
+    QCOMPARE(model.displayNameFor(QStringLiteral("1")), QStringLiteral("Renamed"));
+}
+
+void TestConversationListModel::reconcilesSeveralMovesInOrder()
+{
+    ConversationListModel model;
+    QVector<ConversationItem> read;
+    for (int i = 0; i < 5; ++i) {
+        read.append(item(QString::number(i)));
+        read.last().lastActivity = QDateTime(QDate(2026, 7, 30), QTime(9, i));
+    }
+    model.reconcile(read);
+
+    // One up past all, one down past all and one a step up, in one read.
+    read[0].lastActivity = QDateTime(QDate(2026, 7, 30), QTime(9, 10));
+    read[4].lastActivity = QDateTime(QDate(2026, 7, 30), QTime(8, 0));
+    read[2].lastActivity = QDateTime(QDate(2026, 7, 30), QTime(9, 3, 30));
+    model.reconcile(read);
+
+    const QStringList expected{ QStringLiteral("0"), QStringLiteral("2"), QStringLiteral("3"),
+                                QStringLiteral("1"), QStringLiteral("4") };
+    for (int row = 0; row < model.rowCount(); ++row) {
+        QCOMPARE(model.data(model.index(row), ConversationListModel::ConversationIdRole).toString(),
+                 expected.at(row));
+        QCOMPARE(model.indexOf(expected.at(row)), row);
+    }
+
+    // Still in order, so a single move afterwards lands where it should.
+    model.updateLastActivity(QStringLiteral("4"), QDateTime(QDate(2026, 7, 30), QTime(9, 2)));
+    QCOMPARE(model.indexOf(QStringLiteral("4")), 3);
+}
+
+void TestConversationListModel::listsTheLatestFirstAmongTheAsRecent()
+{
+    ConversationListModel model;
+    fill(model, 3);
+    const QDateTime top(QDate(2026, 7, 30), QTime(9, 2));
+
+    // As recent as the top row, it goes above it, and each row is still found.
+    model.applyActivity(QStringLiteral("0"), top, QStringLiteral("hi"), false);
+    model.addConversation(QStringLiteral("3"), QStringLiteral("DM 3"), QString(), top, false, QString());
+
+    const QStringList expected{ QStringLiteral("3"), QStringLiteral("0"), QStringLiteral("2"),
+                                QStringLiteral("1") };
+    for (int row = 0; row < model.rowCount(); ++row) {
+        QCOMPARE(model.data(model.index(row), ConversationListModel::ConversationIdRole).toString(),
+                 expected.at(row));
+        QCOMPARE(model.indexOf(expected.at(row)), row);
+    }
+}
+
+void TestConversationListModel::sumsUnreadCountsAsTheyChange()
+{
+    ConversationListModel model;
+    ConversationItem saved = item(QStringLiteral("0"));
+    saved.unreadCount = 4;
+    QSignalSpy counts(&model, &ConversationListModel::unreadCountChanged);
+
+    // A conversation new to the list brings the count it was read with.
+    model.reconcile({ saved, item(QStringLiteral("1")) });
+    QCOMPARE(model.totalUnread(), 4);
+    QCOMPARE(counts.size(), 1);
+
+    model.incrementUnread(QStringLiteral("1"));
+    model.applyActivity(QStringLiteral("1"), QDateTime(QDate(2026, 7, 30), QTime(10, 0)),
+                        QStringLiteral("hi"), true);
+    QCOMPARE(model.totalUnread(), 6);
+    QCOMPARE(counts.last().at(1).toInt(), 2);
+
+    model.clearUnread(QStringLiteral("1"));
+    QCOMPARE(model.totalUnread(), 4);
+
+    // Gone from the list, its count goes with it.
+    model.reconcile({ item(QStringLiteral("1")) });
+    QCOMPARE(model.totalUnread(), 0);
+    QCOMPARE(counts.last().at(0).toString(), QStringLiteral("0"));
+    QCOMPARE(counts.last().at(1).toInt(), 0);
+}
+
+void TestConversationListModel::derivesAvatarAndLabelAsTheRowGoesIn()
+{
+    ConversationListModel model;
+    const QString id = QStringLiteral("0xabcdef0123456789");
+    model.addConversation(id, QStringLiteral("DM"), QString(), QDateTime(QDate(2026, 7, 30), QTime(9, 0)), false,
+                          QString());
+    model.reconcile({ item(id), item(QStringLiteral("1")) });
+
+    for (int row = 0; row < model.rowCount(); ++row) {
+        const QModelIndex at = model.index(row);
+        const QString rowId = model.data(at, ConversationListModel::ConversationIdRole).toString();
+        QCOMPARE(model.data(at, ConversationListModel::AvatarInitialsRole).toString(), Identity::initials(rowId));
+        QCOMPARE(model.data(at, ConversationListModel::AvatarRampRole).toInt(),
+                 Identity::avatarRamp(Identity::shortLabel(rowId)));
+        QVERIFY(!model.data(at, ConversationListModel::LastActivityDisplayRole).toString().isEmpty());
+    }
+
+    // Activity today is labelled with its time, not the date it had.
+    const auto labelOf = [&model](const QString& rowId) {
+        return model.data(model.index(model.indexOf(rowId)), ConversationListModel::LastActivityDisplayRole)
+            .toString();
+    };
+    const QString before = labelOf(id);
+    model.updateLastActivity(id, QDateTime::currentDateTime());
+    QVERIFY(labelOf(id) != before);
+}
+
+void TestConversationListModel::listsTheTopAndTheUnreadAsLikelyNext()
+{
+    ConversationListModel model;
+    fill(model, 6);
+    model.incrementUnread(QStringLiteral("0"));
+    model.incrementUnread(QStringLiteral("4"));
+
+    QCOMPARE(model.likelyNext(2), (QStringList{ QStringLiteral("5"), QStringLiteral("4"), QStringLiteral("0") }));
+    QCOMPARE(model.likelyNext(0), (QStringList{ QStringLiteral("4"), QStringLiteral("0") }));
+}
+
+QTEST_MAIN(TestConversationListModel)
+#include "tst_conversationlistmodel.moc"
@@ -0,0 +1,165 @@
+#include <QDateTime>
+#include <QSignalSpy>
+#include <QTest>
+
+#include "ConversationFilterModel.h"
+#include "ConversationListModel.h"
+#include "ConversationSearchIndex.h"
+
+class TestConversationSearch : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void matchesEachWordByItsStart();
+    void forgetsTextThatChanged();
+    void listsMatchesInTheListsOrder();
+    void followsTheListAsItChanges();
+    void followsAReadThatOnlyRemoves();
+    void movesAMatchRatherThanResetting();
+
+private:
+    static QStringList idsOf(const ConversationFilterModel& filter);
+};
+
+QStringList TestConversationSearch::idsOf(const ConversationFilterModel& filter)
+{
+    QStringList ids;
+    for (int row = 0; row < filter.rowCount(); ++row)
+        ids.append(filter.data(filter.index(row), ConversationListModel::ConversationIdRole).toString());
+    return ids;
+}
+
+void TestConversationSearch::matchesEachWordByItsStart()
+{
+    ConversationSearchIndex index;
+    index.set(QStringLiteral("a"), { QStringLiteral("Book Club"), QStringLiteral("Reading, monthly") });
+    index.set(QStringLiteral("b"), { QStringLiteral("Bookkeeping") });
+    index.set(QStringLiteral("c"), { QStringLiteral("Climbing club") });
+
+    QCOMPARE(index.match(QStringLiteral("bo")), (QSet<QString>{ QStringLiteral("a"), QStringLiteral("b") }));
+    QCOMPARE(index.match(QStringLiteral("CLUB")), (QSet<QString>{ QStringLiteral("a"), QStringLiteral("c") }));
+    // Every word has to match, in any order and in any field.
+    QCOMPARE(index.match(QStringLiteral("month club")), QSet<QString>{ QStringLiteral("a") });
+    // Inside a word is not its start.
+    QVERIFY(index.match(QStringLiteral("keeping")).isEmpty());
+    QVERIFY(index.match(QStringLiteral(" , ")).isEmpty());
+}
+
+void TestConversationSearch::forgetsTextThatChanged()
+{
+    ConversationSearchIndex index;
+    index.set(QStringLiteral("a"), { QStringLiteral("Book Club") });
+
+    index.set(QStringLiteral("a"), { QStringLiteral("Film Club") });
+    QVERIFY(index.match(QStringLiteral("book")).isEmpty());
+    QCOMPARE(index.match(QStringLiteral("film")), QSet<QString>{ QStringLiteral("a") });
+
+    index.remove(QStringLiteral("a"));
+    QVERIFY(index.match(QStringLiteral("club")).isEmpty());
+}
+
+void TestConversationSearch::listsMatchesInTheListsOrder()
+{
+    ConversationListModel model;
+    ConversationFilterModel filter(&model);
+    for (int i = 0; i < 4; ++i) {
+        const QString team = i % 2 ? QStringLiteral("red") : QStringLiteral("blue");
+        model.addConversation(QString::number(i), QStringLiteral("Team ") + team, QString(),
+                              QDateTime(QDate(2026, 7, 30), QTime(9, i)), true, QString());
+    }
+
+    QCOMPARE(filter.rowCount(), 0);
+    filter.setQuery(QStringLiteral("team r"));
+
+    QCOMPARE(idsOf(filter), (QStringList{ QStringLiteral("3"), QStringLiteral("1") }));
+    QCOMPARE(filter.data(filter.index(1), ConversationListModel::DisplayNameRole).toString(),
+             QStringLiteral("Team red"));
+}
+
+void TestConversationSearch::followsTheListAsItChanges()
+{
+    ConversationListModel model;
+    ConversationFilterModel filter(&model);
+    for (int i = 0; i < 3; ++i)
+        model.addConversation(QString::number(i), QStringLiteral("DM %1").arg(i), QString(),
+                              QDateTime(QDate(2026, 7, 30), QTime(9, i)), false, QString());
+    filter.setQuery(QStringLiteral("hello"));
+    QSignalSpy reset(&filter, &QAbstractItemModel::modelReset);
+    QSignalSpy inserted(&filter, &QAbstractItemModel::rowsInserted);
+    QSignalSpy changed(&filter, &QAbstractItemModel::dataChanged);
+
+    // Inserted with its data as it is, so not told of the change as well.
+    model.applyActivity(QStringLiteral("0"), QDateTime(QDate(2026, 7, 30), QTime(10, 0)),
+                        QStringLiteral("hello there"), true);
+    QCOMPARE(idsOf(filter), QStringList{ QStringLiteral("0") });
+    QCOMPARE(inserted.size(), 1);
+    QCOMPARE(changed.size(), 0);
+
+    // A match that only moves or counts a message keeps the rows listed.
+    model.applyActivity(QStringLiteral("0"), QDateTime(QDate(2026, 7, 30), QTime(10, 0)),
+                        QStringLiteral("hello there"), true);
+    QCOMPARE(inserted.size(), 1);
+    QCOMPARE(changed.size(), 1);
+    QCOMPARE(changed.last().at(2).value<QList<int>>(), QList<int>{ ConversationListModel::UnreadCountRole });
+    QCOMPARE(filter.data(filter.index(0), ConversationListModel::UnreadCountRole).toInt(), 2);
+
+    model.removeConversation(QStringLiteral("0"));
+    QCOMPARE(filter.rowCount(), 0);
+    QCOMPARE(reset.size(), 0);
+}
+
+void TestConversationSearch::movesAMatchRatherThanResetting()
+{
+    ConversationListModel model;
+    ConversationFilterModel filter(&model);
+    for (int i = 0; i < 5; ++i)
+        model.addConversation(QString::number(i), QStringLiteral("Team %1").arg(i), QString(),
+                              QDateTime(QDate(2026, 7, 30), QTime(9, i)), true, QString());
+    filter.setQuery(QStringLiteral("team"));
+    QSignalSpy reset(&filter, &QAbstractItemModel::modelReset);
+    QSignalSpy moved(&filter, &QAbstractItemModel::rowsMoved);
+    QSignalSpy removed(&filter, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy inserted(&filter, &QAbstractItemModel::rowsInserted);
+
+    // The least recent match goes to the top as one move.
+    model.applyActivity(QStringLiteral("0"), QDateTime(QDate(2026, 7, 30), QTime(10, 0)),
+                        QStringLiteral("hi"), false);
+    QCOMPARE(idsOf(filter), (QStringList{ QStringLiteral("0"), QStringLiteral("4"), QStringLiteral("3"),
+                                          QStringLiteral("2"), QStringLiteral("1") }));
+    QCOMPARE(moved.size(), 1);
+
+    // A narrower query only removes, a wider one only inserts.
+    filter.setQuery(QStringLiteral("team 3"));
+    QCOMPARE(idsOf(filter), QStringList{ QStringLiteral("3") });
+    QCOMPARE(removed.size(), 2);
+    filter.setQuery(QStringLiteral("team"));
+    QCOMPARE(idsOf(filter), (QStringList{ QStringLiteral("0"), QStringLiteral("4"), QStringLiteral("3"),
+                                          QStringLiteral("2"), QStringLiteral("1") }));
+    QCOMPARE(inserted.size(), 2);
+    QCOMPARE(moved.size(), 1);
+    QCOMPARE(reset.size(), 0);
+}
+
+void TestConversationSearch::followsAReadThatOnlyRemoves()
+{
+    ConversationListModel model;
+    ConversationFilterModel filter(&model);
+    QVector<ConversationItem> read;
+    for (int i = 0; i < 6; ++i)
+        read.append({ QString::number(i), QStringLiteral("Team %1").arg(i), QString(),
+                      QDateTime(QDate(2026, 7, 30), QTime(9, i)), 0, false, QString() });
+    model.reconcile(read);
+    filter.setQuery(QStringLiteral("team"));
+
+    // Two runs apart, listed as 5 4 3 2 1 0: the 4 and the 1 go.
+    read.removeAt(4);
+    read.removeAt(1);
+    model.reconcile(read);
+
+    QCOMPARE(idsOf(filter), (QStringList{ QStringLiteral("5"), QStringLiteral("3"), QStringLiteral("2"),
+                                          QStringLiteral("0") }));
+}
+
+QTEST_MAIN(TestConversationSearch)
+#include "tst_conversationsearch.moc"
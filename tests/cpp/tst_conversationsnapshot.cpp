@@ -0,0 +1,66 @@
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "ConversationSnapshot.h"
+
+class TestConversationSnapshot : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void restoresWhatItSaved();
+    void refusesAFileThatIsNotItsOwn();
+
+private:
+    static QString pathIn(const QTemporaryDir& dir);
+};
+
+QString TestConversationSnapshot::pathIn(const QTemporaryDir& dir)
+{
+    return QDir(dir.path()).filePath(QString::fromLatin1(ConversationSnapshot::kFileName));
+}
+
+void TestConversationSnapshot::restoresWhatItSaved()
+{
+    QTemporaryDir dir;
+    const QVector<ConversationItem> saved{
+        { QStringLiteral("b"), QStringLiteral("Book Club"), QStringLiteral("Monthly"),
+          QDateTime(QDate(2026, 7, 30), QTime(10, 0)), 3, true, QStringLiteral("see you") },
+        { QStringLiteral("a"), QStringLiteral("DM a"), QString(), QDateTime(), 0, false, QString() },
+    };
+    QVERIFY(ConversationSnapshot::save(pathIn(dir), saved));
+
+    QVector<ConversationItem> read;
+    QVERIFY(ConversationSnapshot::load(pathIn(dir), &read));
+
+    QCOMPARE(read.size(), 2);
+    QCOMPARE(read.at(0).conversationId, QStringLiteral("b"));
+    QCOMPARE(read.at(0).description, QStringLiteral("Monthly"));
+    QCOMPARE(read.at(0).lastActivity, QDateTime(QDate(2026, 7, 30), QTime(10, 0)));
+    QVERIFY(read.at(0).isGroup);
+    QCOMPARE(read.at(0).preview, QStringLiteral("see you"));
+    // Unread counts are the unread store's to keep.
+    QCOMPARE(read.at(0).unreadCount, 0);
+    QVERIFY(!read.at(1).lastActivity.isValid());
+}
+
+void TestConversationSnapshot::refusesAFileThatIsNotItsOwn()
+{
+    QTemporaryDir dir;
+    QVector<ConversationItem> read{ { QStringLiteral("kept") } };
+    QVERIFY(!ConversationSnapshot::load(pathIn(dir), &read));
+
+    QFile file(pathIn(dir));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("not a snapshot");
+    file.close();
+
+    QVERIFY(!ConversationSnapshot::load(pathIn(dir), &read));
+    QCOMPARE(read.size(), 1);
+    QCOMPARE(read.at(0).conversationId, QStringLiteral("kept"));
+}
+
+QTEST_MAIN(TestConversationSnapshot)
+#include "tst_conversationsnapshot.moc"
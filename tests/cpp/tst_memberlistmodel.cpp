@@ -0,0 +1,128 @@
+#include <QSignalSpy>
+#include <QTest>
+
+#include "MemberListModel.h"
+
+class TestMemberListModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void commitsAnInviteAsOneRolesChange();
+    void insertsAndRemovesOnlyTheMembersThatChanged();
+    void countsCommittedAndPendingAsRowsChange();
+    void findsAMemberByAddress();
+
+private:
+    // A committed member per letter of `addresses`, that letter its address.
+    static QVector<MemberItem> roster(const QString& addresses);
+    static QString addressesOf(const MemberListModel& model);
+};
+
+QVector<MemberItem> TestMemberListModel::roster(const QString& addresses)
+{
+    QVector<MemberItem> members;
+    for (const QChar address : addresses)
+        members.append({ QString(address), false, false });
+    return members;
+}
+
+QString TestMemberListModel::addressesOf(const MemberListModel& model)
+{
+    QString addresses;
+    for (int row = 0; row < model.rowCount(); ++row)
+        addresses += model.data(model.index(row), MemberListModel::AddressRole).toString();
+    return addresses;
+}
+
+void TestMemberListModel::commitsAnInviteAsOneRolesChange()
+{
+    MemberListModel model;
+    QVector<MemberItem> members = roster(QStringLiteral("abcd"));
+    members[2].pending = true;
+    model.setMembers(members);
+    QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+
+    members[2].pending = false;
+    model.setMembers(members);
+
+    QCOMPARE(reset.size(), 0);
+    QCOMPARE(changed.size(), 1);
+    QCOMPARE(changed.first().at(0).toModelIndex().row(), 2);
+    QCOMPARE(changed.first().at(2).value<QList<int>>(), QList<int>{ MemberListModel::PendingRole });
+    QVERIFY(model.contains(QStringLiteral("c")));
+}
+
+void TestMemberListModel::insertsAndRemovesOnlyTheMembersThatChanged()
+{
+    MemberListModel model;
+    model.setMembers(roster(QStringLiteral("abcde")));
+    QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+
+    // b and c gone as one run, x and y in as one, e moved ahead of d.
+    model.setMembers(roster(QStringLiteral("axyed")));
+
+    QCOMPARE(addressesOf(model), QStringLiteral("axyed"));
+    QCOMPARE(reset.size(), 0);
+    QCOMPARE(removed.size(), 2);
+    QCOMPARE(removed.first().at(1).toInt(), 1);
+    QCOMPARE(removed.first().at(2).toInt(), 2);
+    QCOMPARE(inserted.size(), 2);
+    QCOMPARE(inserted.first().at(1).toInt(), 1);
+    QCOMPARE(inserted.first().at(2).toInt(), 2);
+}
+
+void TestMemberListModel::countsCommittedAndPendingAsRowsChange()
+{
+    MemberListModel model;
+    QVector<MemberItem> members = roster(QStringLiteral("abc"));
+    members[1].pending = true;
+    model.setMembers(members);
+    QCOMPARE(model.committedCount(), 2);
+    QCOMPARE(model.pendingCount(), 1);
+
+    // Two members with no confirmed account, one of them an invite.
+    members.append({ QString(), false, true });
+    members.append({ QString(), false, false });
+    members[1].pending = false;
+    members.removeFirst();
+    model.setMembers(members);
+    QCOMPARE(model.rowCount(), 4);
+    QCOMPARE(model.committedCount(), 3);
+    QCOMPARE(model.pendingCount(), 1);
+
+    model.clear();
+    QCOMPARE(model.committedCount(), 0);
+    QCOMPARE(model.pendingCount(), 0);
+}
+
+void TestMemberListModel::findsAMemberByAddress()
+{
+    MemberListModel model;
+    QVector<MemberItem> members = roster(QStringLiteral("abcd"));
+    members[3].pending = true;
+    model.setMembers(members);
+
+    QCOMPARE(model.indexOfAddress(QStringLiteral("c")), 2);
+    // An invite has a row but is no member yet.
+    QCOMPARE(model.indexOfAddress(QStringLiteral("d")), 3);
+    QVERIFY(!model.contains(QStringLiteral("d")));
+    QCOMPARE(model.indexOfAddress(QStringLiteral("z")), -1);
+
+    members.removeFirst();
+    members[2].pending = false;
+    model.setMembers(members);
+    QCOMPARE(model.indexOfAddress(QStringLiteral("a")), -1);
+    QVERIFY(!model.contains(QStringLiteral("a")));
+    QCOMPARE(model.indexOfAddress(QStringLiteral("c")), 1);
+    QVERIFY(model.contains(QStringLiteral("d")));
+
+    model.clear();
+    QCOMPARE(model.indexOfAddress(QStringLiteral("b")), -1);
+}
+
+QTEST_MAIN(TestMemberListModel)
+#include "tst_memberlistmodel.moc"
@@ -0,0 +1,299 @@
+#include <QDateTime>
+#include <QSignalSpy>
+#include <QTest>
+
+#include "MessageListModel.h"
+
+class TestMessageListModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void opensOnTheNewestPage();
+    void fetchesOlderHistoryAPageAtATime();
+    void keepsAShortThreadWhole();
+    void forgetsHeldBackHistoryOnClear();
+    void groupsARunOfOneSender();
+    void regroupsTheRowAFetchedPageLandsBeneath();
+    void insertsABurstOfLiveMessagesAtOnce();
+    void dropsADuplicateOfAnyLoadedMessage();
+    void placesALateMessageByItsTimestamp();
+    void holdsBackALateMessageOlderThanEveryRow();
+    void reconcilesAResyncAsTheMessagesItGained();
+    void reconcilesAMessageGoneAndOneFilledIn();
+    void regroupsOnlyTheRowAboveAReconciledEdit();
+
+private:
+    // A thread of `count` messages, oldest-first as get_messages returns it, a
+    // minute apart and numbered by content so a row can be named.
+    static QVector<MessageItem> thread(int count);
+    static QString contentAt(const MessageListModel& model, int row);
+};
+
+QVector<MessageItem> TestMessageListModel::thread(int count)
+{
+    const qint64 start = QDateTime(QDate(2026, 7, 30), QTime(9, 0)).toMSecsSinceEpoch();
+    QVector<MessageItem> items;
+    for (int i = 0; i < count; ++i)
+        items.append({ QStringLiteral("alice"), QString::number(i), start + i * 60000, false });
+    return items;
+}
+
+QString TestMessageListModel::contentAt(const MessageListModel& model, int row)
+{
+    return model.data(model.index(row), MessageListModel::ContentRole).toString();
+}
+
+void TestMessageListModel::opensOnTheNewestPage()
+{
+    MessageListModel model;
+
+    model.setMessages(thread(MessageListModel::kPageSize * 2 + 10));
+
+    QCOMPARE(model.rowCount(), MessageListModel::kPageSize);
+    // Newest-first: row 0 is the last message the thread holds.
+    QCOMPARE(contentAt(model, 0), QString::number(MessageListModel::kPageSize * 2 + 9));
+    QVERIFY(model.canFetchMore(QModelIndex()));
+}
+
+void TestMessageListModel::fetchesOlderHistoryAPageAtATime()
+{
+    MessageListModel model;
+    model.setMessages(thread(MessageListModel::kPageSize * 2 + 10));
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+
+    model.fetchMore(QModelIndex());
+
+    QCOMPARE(model.rowCount(), MessageListModel::kPageSize * 2);
+    // Appended below the rows already shown, as one insert.
+    QCOMPARE(inserted.size(), 1);
+    QCOMPARE(inserted.first().at(1).toInt(), MessageListModel::kPageSize);
+    QCOMPARE(contentAt(model, MessageListModel::kPageSize - 1), QString::number(MessageListModel::kPageSize + 10));
+    QCOMPARE(contentAt(model, MessageListModel::kPageSize), QString::number(MessageListModel::kPageSize + 9));
+
+    model.fetchMore(QModelIndex());
+
+    QCOMPARE(model.rowCount(), MessageListModel::kPageSize * 2 + 10);
+    QCOMPARE(contentAt(model, model.rowCount() - 1), QStringLiteral("0"));
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+}
+
+void TestMessageListModel::keepsAShortThreadWhole()
+{
+    MessageListModel model;
+
+    model.setMessages(thread(3));
+
+    QCOMPARE(model.rowCount(), 3);
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+}
+
+void TestMessageListModel::forgetsHeldBackHistoryOnClear()
+{
+    MessageListModel model;
+    model.setMessages(thread(MessageListModel::kPageSize + 1));
+
+    model.clear();
+
+    QCOMPARE(model.rowCount(), 0);
+    // The held-back page was the conversation left behind, not the next one's.
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+}
+
+void TestMessageListModel::groupsARunOfOneSender()
+{
+    MessageListModel model;
+    model.setMessages(thread(2));
+
+    model.addMessage(QStringLiteral("bob"), QStringLiteral("hi"),
+                     QDateTime(QDate(2026, 7, 30), QTime(10, 0)).toMSecsSinceEpoch(), false);
+
+    // Row 0 is bob's, breaking alice's run; row 1 continues it; row 2 starts
+    // the thread and so the day.
+    QVERIFY(!model.data(model.index(0), MessageListModel::SameSenderAsPreviousRole).toBool());
+    QVERIFY(model.data(model.index(1), MessageListModel::SameSenderAsPreviousRole).toBool());
+    QVERIFY(!model.data(model.index(1), MessageListModel::ShowDaySeparatorRole).toBool());
+    QVERIFY(model.data(model.index(2), MessageListModel::ShowDaySeparatorRole).toBool());
+}
+
+void TestMessageListModel::regroupsTheRowAFetchedPageLandsBeneath()
+{
+    MessageListModel model;
+    model.setMessages(thread(MessageListModel::kPageSize + 1));
+    const int boundary = MessageListModel::kPageSize - 1;
+    // Nothing beneath the oldest loaded row yet, so it opens a day.
+    QVERIFY(model.data(model.index(boundary), MessageListModel::ShowDaySeparatorRole).toBool());
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+
+    model.fetchMore(QModelIndex());
+
+    QVERIFY(!model.data(model.index(boundary), MessageListModel::ShowDaySeparatorRole).toBool());
+    QVERIFY(model.data(model.index(boundary), MessageListModel::SameSenderAsPreviousRole).toBool());
+    QCOMPARE(changed.size(), 1);
+    QCOMPARE(changed.first().at(0).toModelIndex().row(), boundary);
+}
+
+void TestMessageListModel::insertsABurstOfLiveMessagesAtOnce()
+{
+    MessageListModel model;
+    QVector<MessageItem> loaded = thread(3);
+    model.setMessages(loaded);
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    const qint64 later = QDateTime(QDate(2026, 7, 30), QTime(11, 0)).toMSecsSinceEpoch();
+
+    // The newest loaded message again, as a resync overlapping a live push
+    // delivers it, then two new ones.
+    model.addNewMessages({ loaded.last(),
+                           { QStringLiteral("bob"), QStringLiteral("a"), later, false },
+                           { QStringLiteral("bob"), QStringLiteral("b"), later + 1000, false } });
+
+    QCOMPARE(inserted.size(), 1);
+    QCOMPARE(inserted.first().at(1).toInt(), 0);
+    QCOMPARE(inserted.first().at(2).toInt(), 1);
+    QCOMPARE(model.rowCount(), 5);
+    QCOMPARE(contentAt(model, 0), QStringLiteral("b"));
+    QCOMPARE(contentAt(model, 1), QStringLiteral("a"));
+    QVERIFY(model.data(model.index(0), MessageListModel::SameSenderAsPreviousRole).toBool());
+    QVERIFY(!model.data(model.index(1), MessageListModel::SameSenderAsPreviousRole).toBool());
+}
+
+void TestMessageListModel::dropsADuplicateOfAnyLoadedMessage()
+{
+    MessageListModel model;
+    QVector<MessageItem> loaded = thread(MessageListModel::kPageSize + 5);
+    model.setMessages(loaded);
+    const qint64 later = QDateTime(QDate(2026, 7, 30), QTime(23, 0)).toMSecsSinceEpoch();
+
+    // A resync overlapping several live pushes: one deep in the rows, one still
+    // held back, and the newest, among a message the thread has not seen.
+    model.addNewMessages({ loaded.at(MessageListModel::kPageSize),
+                           loaded.at(2),
+                           loaded.last(),
+                           { QStringLiteral("bob"), QStringLiteral("new"), later, false } });
+
+    QCOMPARE(model.rowCount(), MessageListModel::kPageSize + 1);
+    QCOMPARE(contentAt(model, 0), QStringLiteral("new"));
+    // A copy within the batch is caught too.
+    model.addNewMessages({ { QStringLiteral("bob"), QStringLiteral("x"), later + 1000, false },
+                           { QStringLiteral("bob"), QStringLiteral("x"), later + 1000, false } });
+    QCOMPARE(model.rowCount(), MessageListModel::kPageSize + 2);
+
+    model.clear();
+    model.addNewMessages({ loaded.last() });
+    QCOMPARE(model.rowCount(), 1);
+}
+
+void TestMessageListModel::placesALateMessageByItsTimestamp()
+{
+    MessageListModel model;
+    const QVector<MessageItem> loaded = thread(3);
+    model.setMessages(loaded);
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+
+    // Sent between the first two messages and delivered after the third, in a
+    // batch with one that is new.
+    model.addNewMessages({ { QStringLiteral("bob"), QStringLiteral("new"), loaded.last().timestampMs + 60000, false },
+                           { QStringLiteral("bob"), QStringLiteral("late"), loaded.first().timestampMs + 30000, false } });
+
+    QCOMPARE(model.rowCount(), 5);
+    QCOMPARE(contentAt(model, 0), QStringLiteral("new"));
+    QCOMPARE(contentAt(model, 3), QStringLiteral("late"));
+    QCOMPARE(inserted.size(), 2);
+    QCOMPARE(inserted.first().at(1).toInt(), 2);
+    // The late message breaks alice's run for the row above it, and only that
+    // row is told.
+    QVERIFY(!model.data(model.index(2), MessageListModel::SameSenderAsPreviousRole).toBool());
+    QCOMPARE(changed.size(), 1);
+    QCOMPARE(changed.first().at(0).toModelIndex().row(), 1);
+}
+
+void TestMessageListModel::holdsBackALateMessageOlderThanEveryRow()
+{
+    MessageListModel model;
+    const QVector<MessageItem> loaded = thread(MessageListModel::kPageSize + 1);
+    model.setMessages(loaded);
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+
+    model.addNewMessages({ { QStringLiteral("bob"), QStringLiteral("late"), loaded.first().timestampMs - 60000, false } });
+
+    // It waits with the rest of the older history rather than showing above it.
+    QCOMPARE(inserted.size(), 0);
+    QCOMPARE(model.rowCount(), MessageListModel::kPageSize);
+    model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(), MessageListModel::kPageSize + 2);
+    QCOMPARE(contentAt(model, model.rowCount() - 1), QStringLiteral("late"));
+}
+
+void TestMessageListModel::reconcilesAResyncAsTheMessagesItGained()
+{
+    MessageListModel model;
+    QVector<MessageItem> fresh = thread(10000);
+    model.setMessages(fresh);
+    model.fetchMore(QModelIndex());
+    const int rowsBefore = model.rowCount();
+    const qint64 later = QDateTime(QDate(2026, 8, 30), QTime(9, 0)).toMSecsSinceEpoch();
+    for (int i = 0; i < 5; ++i)
+        fresh.append({ QStringLiteral("bob"), QStringLiteral("new %1").arg(i), later + i * 1000, false });
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+
+    model.reconcile(fresh);
+
+    QCOMPARE(reset.size(), 0);
+    QCOMPARE(removed.size(), 0);
+    QCOMPARE(inserted.size(), 1);
+    QCOMPARE(inserted.first().at(1).toInt(), 0);
+    QCOMPARE(inserted.first().at(2).toInt(), 4);
+    QCOMPARE(model.rowCount(), rowsBefore + 5);
+    QCOMPARE(contentAt(model, 0), QStringLiteral("new 4"));
+    // History further back is still there to fetch.
+    QVERIFY(model.canFetchMore(QModelIndex()));
+}
+
+void TestMessageListModel::reconcilesAMessageGoneAndOneFilledIn()
+{
+    MessageListModel model;
+    QVector<MessageItem> fresh = thread(6);
+    const MessageItem late = fresh.takeAt(3);
+    model.setMessages(fresh);
+    // The module has since dropped one message and caught up on one it missed.
+    fresh.removeAt(1);
+    fresh.insert(2, late);
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+
+    model.reconcile(fresh);
+
+    QCOMPARE(inserted.size(), 1);
+    QCOMPARE(removed.size(), 1);
+    QCOMPARE(model.rowCount(), 5);
+    const QStringList expected{ QStringLiteral("5"), QStringLiteral("4"), QStringLiteral("3"),
+                                QStringLiteral("2"), QStringLiteral("0") };
+    for (int row = 0; row < expected.size(); ++row)
+        QCOMPARE(contentAt(model, row), expected.at(row));
+}
+
+void TestMessageListModel::regroupsOnlyTheRowAboveAReconciledEdit()
+{
+    MessageListModel model;
+    QVector<MessageItem> fresh = thread(6);
+    model.setMessages(fresh);
+    // Bob, caught up on, between alice's third and fourth.
+    fresh.insert(3, { QStringLiteral("bob"), QStringLiteral("hi"), fresh.at(2).timestampMs + 1000, false });
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+
+    model.reconcile(fresh);
+
+    // Listed 5 4 3 hi 2 1 0: only alice's "3" has a new sender beneath it.
+    QCOMPARE(contentAt(model, 3), QStringLiteral("hi"));
+    QCOMPARE(changed.size(), 1);
+    QCOMPARE(changed.first().at(0).toModelIndex().row(), 2);
+    QCOMPARE(changed.first().at(1).toModelIndex().row(), 2);
+    QVERIFY(!model.data(model.index(2), MessageListModel::SameSenderAsPreviousRole).toBool());
+    QVERIFY(model.data(model.index(1), MessageListModel::SameSenderAsPreviousRole).toBool());
+}
+
+QTEST_MAIN(TestMessageListModel)
+#include "tst_messagelistmodel.moc"
@@ -0,0 +1,78 @@
+#include <QDateTime>
+#include <QTest>
+
+#include "Identity.h"
+#include "ModuleRecords.h"
+
+class TestModuleRecords : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void decodesMessageRecords();
+    void namesAConversationByNicknameThenName();
+    void stopsWhenCanceled();
+};
+
+void TestModuleRecords::decodesMessageRecords()
+{
+    const QVariantList records{
+        QVariantMap{ { QStringLiteral("from_self"), true },
+                     { QStringLiteral("content"), QStringLiteral("mine") },
+                     { QStringLiteral("timestamp_ms"), qint64(1785402000000) },
+                     { QStringLiteral("sender"), QStringLiteral("0xabc") } },
+        QVariantMap{ { QStringLiteral("content"), QStringLiteral("theirs") } },
+    };
+    const qint64 before = QDateTime::currentMSecsSinceEpoch();
+
+    const QVector<MessageItem> thread = ModuleRecords::decodeMessages(records);
+
+    QCOMPARE(thread.size(), 2);
+    QCOMPARE(thread.at(0).sender, QStringLiteral("Me"));
+    QVERIFY(thread.at(0).isMe);
+    QCOMPARE(thread.at(0).timestampMs, qint64(1785402000000));
+    // A record missing its sender and timestamp still makes a row.
+    QCOMPARE(thread.at(1).sender, QStringLiteral("Peer"));
+    QVERIFY(thread.at(1).timestampMs >= before);
+}
+
+void TestModuleRecords::namesAConversationByNicknameThenName()
+{
+    const QVariantList records{
+        QVariantMap{ { QStringLiteral("convo_id"), QStringLiteral("a") },
+                     { QStringLiteral("nickname"), QStringLiteral("Nick") },
+                     { QStringLiteral("name"), QStringLiteral("Shared") } },
+        QVariantMap{ { QStringLiteral("convo_id"), QStringLiteral("b") },
+                     { QStringLiteral("name"), QStringLiteral("Shared") },
+                     { QStringLiteral("kind"), QStringLiteral("group") } },
+        QVariantMap{ { QStringLiteral("convo_id"), QStringLiteral("c") } },
+        QVariantMap{ { QStringLiteral("name"), QStringLiteral("no id") } },
+    };
+
+    const QVector<ConversationItem> conversations = ModuleRecords::decodeConversations(records);
+
+    QCOMPARE(conversations.size(), 3);
+    QCOMPARE(conversations.at(0).displayName, QStringLiteral("Nick"));
+    QCOMPARE(conversations.at(1).displayName, QStringLiteral("Shared"));
+    QVERIFY(conversations.at(1).isGroup);
+    QCOMPARE(conversations.at(2).displayName, QStringLiteral("DM ") + Identity::shortLabel(QStringLiteral("c")));
+}
+
+void TestModuleRecords::stopsWhenCanceled()
+{
+    QVariantList records;
+    for (int i = 0; i < 1000; ++i)
+        records.append(QVariantMap{ { QStringLiteral("content"), QString::number(i) } });
+    int asked = 0;
+
+    const QVector<MessageItem> thread = ModuleRecords::decodeMessages(records, [&asked] {
+        return ++asked > 1;
+    });
+
+    // Abandoned at the second look, well short of the end.
+    QVERIFY(thread.isEmpty());
+    QCOMPARE(asked, 2);
+}
+
+QTEST_MAIN(TestModuleRecords)
+#include "tst_modulerecords.moc"
@@ -0,0 +1,195 @@
+#include <QTest>
+
+#include "ReadScheduler.h"
+
+class TestReadScheduler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void runsOneReadAtATime();
+    void runsTheUsersFirst();
+    void asksOnceForAReadAskedForAgain();
+    void ignoresAnAnswerItIsNotWaitingFor();
+    void givesUpOnAReadNeverAnswered();
+    void abandonsAReadNoLongerWanted();
+
+private:
+    using Priority = ReadScheduler::Priority;
+    // A read that records its key and ticket in `started` as it goes out.
+    static ReadScheduler::Start recordInto(QList<QPair<QString, quint64>>& started, const QString& key);
+};
+
+ReadScheduler::Start TestReadScheduler::recordInto(QList<QPair<QString, quint64>>& started, const QString& key)
+{
+    return [&started, key](quint64 ticket) { started.append({ key, ticket }); };
+}
+
+void TestReadScheduler::runsOneReadAtATime()
+{
+    ReadScheduler reads;
+    QList<QPair<QString, quint64>> started;
+
+    reads.request(QStringLiteral("list_conversations"), QString(), Priority::Background,
+                  recordInto(started, QStringLiteral("list")));
+    reads.request(QStringLiteral("get_address"), QString(), Priority::Background,
+                  recordInto(started, QStringLiteral("address")));
+
+    QCOMPARE(started.size(), 1);
+    QVERIFY(reads.isRunning());
+    QCOMPARE(reads.waiting(), 1);
+
+    reads.finish(started.last().second);
+    QCOMPARE(started.size(), 2);
+    QCOMPARE(started.last().first, QStringLiteral("address"));
+
+    reads.finish(started.last().second);
+    QVERIFY(!reads.isRunning());
+    QCOMPARE(reads.waiting(), 0);
+}
+
+void TestReadScheduler::runsTheUsersFirst()
+{
+    ReadScheduler reads;
+    QList<QPair<QString, quint64>> started;
+    reads.request(QStringLiteral("get_address"), QString(), Priority::Background,
+                  recordInto(started, QStringLiteral("address")));
+
+    reads.request(QStringLiteral("list_conversations"), QString(), Priority::Background,
+                  recordInto(started, QStringLiteral("list")));
+    reads.request(QStringLiteral("get_messages"), QStringLiteral("a"), Priority::User,
+                  recordInto(started, QStringLiteral("a")));
+    reads.request(QStringLiteral("list_group_members"), QStringLiteral("a"), Priority::User,
+                  recordInto(started, QStringLiteral("members")));
+
+    // Asked for last, the user's still go out first, in the order asked.
+    for (int i = 0; i < 3; ++i)
+        reads.finish(started.last().second);
+    QCOMPARE(started.size(), 4);
+    QCOMPARE(started.at(1).first, QStringLiteral("a"));
+    QCOMPARE(started.at(2).first, QStringLiteral("members"));
+    QCOMPARE(started.at(3).first, QStringLiteral("list"));
+}
+
+void TestReadScheduler::asksOnceForAReadAskedForAgain()
+{
+    ReadScheduler reads;
+    QList<QPair<QString, quint64>> started;
+    QList<ReadScheduler::Timing> timings;
+    reads.setFinishedHandler([&timings](const ReadScheduler::Timing& timing) { timings.append(timing); });
+    reads.request(QStringLiteral("list_conversations"), QString(), Priority::Background,
+                  recordInto(started, QStringLiteral("list")));
+
+    // The user moved from a to b while the list was being read, and the
+    // refresh behind it was asked for twice.
+    reads.request(QStringLiteral("get_messages"), QStringLiteral("a"), Priority::User,
+                  recordInto(started, QStringLiteral("a")));
+    reads.request(QStringLiteral("list_conversations"), QString(), Priority::Background,
+                  recordInto(started, QStringLiteral("list")));
+    reads.request(QStringLiteral("list_conversations"), QString(), Priority::Background,
+                  recordInto(started, QStringLiteral("list")));
+    reads.request(QStringLiteral("get_messages"), QStringLiteral("b"), Priority::Background,
+                  recordInto(started, QStringLiteral("b")));
+    QCOMPARE(reads.waiting(), 2);
+
+    for (int i = 0; i < 3; ++i)
+        reads.finish(started.last().second);
+    QCOMPARE(started.size(), 3);
+    // The replacement keeps the priority of the read it replaced.
+    QCOMPARE(started.at(1).first, QStringLiteral("b"));
+    QCOMPARE(started.at(2).first, QStringLiteral("list"));
+
+    QCOMPARE(timings.size(), 3);
+    QCOMPARE(timings.at(1).kind, QStringLiteral("get_messages"));
+    QCOMPARE(timings.at(1).key, QStringLiteral("b"));
+    QVERIFY(timings.at(1).priority == Priority::User);
+    QVERIFY(timings.at(1).waitedMs >= 0);
+    QVERIFY(timings.at(1).ranMs >= 0);
+}
+
+void TestReadScheduler::ignoresAnAnswerItIsNotWaitingFor()
+{
+    ReadScheduler reads;
+    QList<QPair<QString, quint64>> started;
+    reads.request(QStringLiteral("get_messages"), QStringLiteral("a"), Priority::User,
+                  recordInto(started, QStringLiteral("a")));
+    reads.request(QStringLiteral("list_group_members"), QStringLiteral("a"), Priority::User,
+                  recordInto(started, QStringLiteral("members")));
+    reads.request(QStringLiteral("get_address"), QString(), Priority::Background,
+                  recordInto(started, QStringLiteral("address")));
+
+    reads.finish(started.last().second + 1);
+    QCOMPARE(started.size(), 1);
+
+    // A cancel leaves the read already out alone.
+    reads.cancel(QStringLiteral("get_messages"));
+    reads.cancel(QStringLiteral("list_group_members"));
+    QCOMPARE(reads.waiting(), 1);
+    reads.finish(started.last().second);
+    QCOMPARE(started.last().first, QStringLiteral("address"));
+
+    // Answered twice, it lets only one read through.
+    const quint64 first = started.first().second;
+    reads.finish(first);
+    QVERIFY(reads.isRunning());
+}
+
+void TestReadScheduler::givesUpOnAReadNeverAnswered()
+{
+    ReadScheduler reads;
+    reads.setTimeout(20);
+    QList<QPair<QString, quint64>> started;
+    QList<ReadScheduler::Timing> timings;
+    reads.setFinishedHandler([&timings](const ReadScheduler::Timing& timing) { timings.append(timing); });
+    int expired = 0;
+    // The reads after it are given all the time they need, so only the one
+    // never answered times out.
+    reads.request(QStringLiteral("list_conversations"), QString(), Priority::Background,
+                  recordInto(started, QStringLiteral("list")), [&expired, &reads] {
+                      ++expired;
+                      reads.setTimeout(0);
+                  });
+    reads.request(QStringLiteral("get_messages"), QStringLiteral("a"), Priority::User,
+                  recordInto(started, QStringLiteral("a")), [&expired] { ++expired; });
+
+    // The list never answers, and the thread behind it goes out all the same.
+    QTRY_COMPARE(started.size(), 2);
+    QCOMPARE(expired, 1);
+    QVERIFY(timings.first().timedOut);
+    // Answered late, it is refused, and does not end the read now out.
+    QVERIFY(!reads.finish(started.first().second));
+    QVERIFY(reads.isRunning());
+
+    QVERIFY(reads.finish(started.last().second));
+    QVERIFY(!timings.last().timedOut);
+    QCOMPARE(expired, 1);
+}
+
+void TestReadScheduler::abandonsAReadNoLongerWanted()
+{
+    ReadScheduler reads;
+    QList<QPair<QString, quint64>> started;
+    QList<ReadScheduler::Timing> timings;
+    reads.setFinishedHandler([&timings](const ReadScheduler::Timing& timing) { timings.append(timing); });
+    int expired = 0;
+    reads.request(QStringLiteral("prefetch_messages"), QStringLiteral("b"), Priority::Background,
+                  recordInto(started, QStringLiteral("b")), [&expired] { ++expired; });
+    reads.request(QStringLiteral("get_messages"), QStringLiteral("a"), Priority::User,
+                  recordInto(started, QStringLiteral("a")));
+
+    // Only the kind out is abandoned.
+    QVERIFY(!reads.abandon(QStringLiteral("get_messages")));
+    QVERIFY(reads.abandon(QStringLiteral("prefetch_messages")));
+    QCOMPARE(started.size(), 2);
+    QCOMPARE(started.last().first, QStringLiteral("a"));
+    QVERIFY(timings.first().abandoned);
+    QCOMPARE(expired, 0);
+
+    // Its answer, coming after all, does not end the read now out.
+    QVERIFY(!reads.finish(started.first().second));
+    QVERIFY(reads.isRunning());
+    QVERIFY(reads.finish(started.last().second));
+}
+
+QTEST_MAIN(TestReadScheduler)
+#include "tst_readscheduler.moc"
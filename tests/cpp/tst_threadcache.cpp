@@ -0,0 +1,126 @@
+#include <QDateTime>
+#include <QTest>
+
+#include "ThreadCache.h"
+
+class TestThreadCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void countsHitsAndMisses();
+    void keepsLiveMessagesForACachedThread();
+    void evictsTheLeastRecentFirst();
+    void refusesAThreadLargerThanTheBudget();
+    void warmsOnlyIntoSpareRoom();
+    void warmsOnlyBelowTheCeiling();
+
+private:
+    static QVector<MessageItem> thread(int count);
+};
+
+QVector<MessageItem> TestThreadCache::thread(int count)
+{
+    const qint64 start = QDateTime(QDate(2026, 7, 30), QTime(9, 0)).toMSecsSinceEpoch();
+    QVector<MessageItem> items;
+    for (int i = 0; i < count; ++i)
+        items.append({ QStringLiteral("alice"), QString::number(i), start + i * 60000, false });
+    return items;
+}
+
+void TestThreadCache::countsHitsAndMisses()
+{
+    ThreadCache cache;
+    QVector<MessageItem> found;
+
+    QVERIFY(!cache.lookup(QStringLiteral("c1"), &found));
+    cache.store(QStringLiteral("c1"), thread(3));
+    QVERIFY(cache.lookup(QStringLiteral("c1"), &found));
+
+    QVERIFY(found == thread(3));
+    QCOMPARE(cache.hits(), 1);
+    QCOMPARE(cache.misses(), 1);
+}
+
+void TestThreadCache::keepsLiveMessagesForACachedThread()
+{
+    ThreadCache cache;
+    cache.store(QStringLiteral("c1"), thread(2));
+    const MessageItem live{ QStringLiteral("bob"), QStringLiteral("late"),
+                            QDateTime(QDate(2026, 7, 30), QTime(12, 0)).toMSecsSinceEpoch(), false };
+
+    cache.append(QStringLiteral("c1"), live);
+    // A thread never shown is not started by a message arriving for it.
+    cache.append(QStringLiteral("c2"), live);
+
+    QVector<MessageItem> found;
+    QVERIFY(cache.lookup(QStringLiteral("c1"), &found));
+    QCOMPARE(found.size(), 3);
+    QCOMPARE(found.last().content, QStringLiteral("late"));
+    QVERIFY(!cache.contains(QStringLiteral("c2")));
+}
+
+void TestThreadCache::evictsTheLeastRecentFirst()
+{
+    ThreadCache cache;
+    cache.store(QStringLiteral("c1"), thread(10));
+    const qint64 oneThread = cache.bytes();
+    cache.setBudget(oneThread * 2);
+    cache.store(QStringLiteral("c2"), thread(10));
+    QVector<MessageItem> found;
+    // Looking c1 up makes c2 the one least recently wanted.
+    QVERIFY(cache.lookup(QStringLiteral("c1"), &found));
+
+    cache.store(QStringLiteral("c3"), thread(10));
+
+    QCOMPARE(cache.size(), 2);
+    QVERIFY(cache.contains(QStringLiteral("c1")));
+    QVERIFY(!cache.contains(QStringLiteral("c2")));
+    QVERIFY(cache.contains(QStringLiteral("c3")));
+    QVERIFY(cache.bytes() <= cache.budget());
+}
+
+void TestThreadCache::refusesAThreadLargerThanTheBudget()
+{
+    ThreadCache cache(1);
+
+    cache.store(QStringLiteral("c1"), thread(1));
+
+    QCOMPARE(cache.size(), 0);
+    QCOMPARE(cache.bytes(), 0);
+}
+
+void TestThreadCache::warmsOnlyIntoSpareRoom()
+{
+    ThreadCache cache;
+    cache.store(QStringLiteral("c1"), thread(10));
+    const qint64 oneThread = cache.bytes();
+    cache.setBudget(oneThread * 2);
+
+    QVERIFY(cache.warm(QStringLiteral("c2"), thread(10), cache.budget()));
+    // Full now, so it neither evicts nor replaces.
+    QVERIFY(!cache.warm(QStringLiteral("c3"), thread(10), cache.budget()));
+    QVERIFY(!cache.warm(QStringLiteral("c1"), thread(1), cache.budget()));
+    QCOMPARE(cache.bytes(), oneThread * 2);
+
+    // Read ahead rather than opened, it is the first to go.
+    cache.store(QStringLiteral("c4"), thread(10));
+    QVERIFY(cache.contains(QStringLiteral("c1")));
+    QVERIFY(!cache.contains(QStringLiteral("c2")));
+    QVERIFY(cache.contains(QStringLiteral("c4")));
+}
+
+void TestThreadCache::warmsOnlyBelowTheCeiling()
+{
+    ThreadCache cache;
+    cache.store(QStringLiteral("c1"), thread(10));
+    const qint64 oneThread = cache.bytes();
+
+    // The budget has room, but the ceiling does not.
+    QVERIFY(!cache.warm(QStringLiteral("c2"), thread(10), oneThread * 2 - 1));
+    QVERIFY(cache.warm(QStringLiteral("c2"), thread(10), oneThread * 2));
+    QCOMPARE(cache.bytes(), oneThread * 2);
+}
+
+QTEST_MAIN(TestThreadCache)
+#include "tst_threadcache.moc"
@@ -0,0 +1,84 @@
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "UnreadStore.h"
+
+class TestUnreadStore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void startsEmptyWithoutAFile();
+    void restoresWhatItSaved();
+    void writesOnlyWhenSomethingChanged();
+    void refusesAFileThatIsNotItsOwn();
+};
+
+void TestUnreadStore::startsEmptyWithoutAFile()
+{
+    QTemporaryDir dir;
+    UnreadStore store;
+
+    QVERIFY(store.open(dir.path()));
+
+    QVERIFY(store.conversations().isEmpty());
+    QCOMPARE(store.path(), QDir(dir.path()).filePath(QString::fromLatin1(UnreadStore::kFileName)));
+}
+
+void TestUnreadStore::restoresWhatItSaved()
+{
+    QTemporaryDir dir;
+    {
+        UnreadStore store;
+        QVERIFY(store.open(dir.path()));
+        store.set(QStringLiteral("a"), 3);
+        store.set(QStringLiteral("b"), 1);
+        store.set(QStringLiteral("b"), 0);
+        QVERIFY(store.save());
+    }
+
+    UnreadStore reopened;
+    QVERIFY(reopened.open(dir.path()));
+
+    QCOMPARE(reopened.count(QStringLiteral("a")), 3);
+    // Read since, so forgotten rather than saved as zero.
+    QCOMPARE(reopened.conversations(), QStringList{ QStringLiteral("a") });
+}
+
+void TestUnreadStore::writesOnlyWhenSomethingChanged()
+{
+    QTemporaryDir dir;
+    UnreadStore store;
+    QVERIFY(store.open(dir.path()));
+
+    store.set(QStringLiteral("a"), 0);
+    QVERIFY(!store.isDirty());
+    QVERIFY(store.save());
+    QVERIFY(!QFile::exists(store.path()));
+
+    store.set(QStringLiteral("a"), 2);
+    QVERIFY(store.isDirty());
+    QVERIFY(store.save());
+    QVERIFY(!store.isDirty());
+    store.set(QStringLiteral("a"), 2);
+    QVERIFY(!store.isDirty());
+}
+
+void TestUnreadStore::refusesAFileThatIsNotItsOwn()
+{
+    QTemporaryDir dir;
+    QFile file(QDir(dir.path()).filePath(QString::fromLatin1(UnreadStore::kFileName)));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("not a count in sight");
+    file.close();
+    UnreadStore store;
+
+    QVERIFY(!store.open(dir.path()));
+
+    QVERIFY(store.conversations().isEmpty());
+}
+
+QTEST_MAIN(TestUnreadStore)
+#include "tst_unreadstore.moc"
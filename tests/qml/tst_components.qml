@@ -80,6 +80,7 @@ Item {
         id: conversationsPaneC
         ConversationsPane {
             conversationModel: conversationsMock
+            conversationSearchModel: conversationsMock
             currentConversationId: "c1"
             online: true
         }
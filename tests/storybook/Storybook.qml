@@ -118,6 +118,7 @@ Rectangle {
                 Layout.fillWidth: true
                 Layout.fillHeight: true
                 conversationModel: conversationsMock
+                conversationSearchModel: conversationsMock
                 currentConversationId: "c2"
                 online: true
             }